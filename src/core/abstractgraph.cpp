@@ -29,7 +29,11 @@ namespace evoplex {
 
 AbstractGraph::AbstractGraph()
     : m_lastNodeId(-1),
-      m_lastEdgeId(-1)
+      m_lastEdgeId(-1),
+      m_edgesRequired(true),
+      m_topologyChanged(false),
+      m_nodesVersion(0),
+      m_edgesVersion(0)
 {
 }
 
@@ -39,6 +43,7 @@ bool AbstractGraph::setup(Trial& trial, AttrsGeneratorPtr edgeGen,
     Q_ASSERT_X(nodes.size() < EVOPLEX_MAX_NODES, "setup", "too many nodes!");
     Q_ASSERT_X(!nodes.empty(), "setup", "set of nodes cannot be empty!");
     m_nodes = nodes;
+    ++m_nodesVersion;
     m_numNodesDist = std::uniform_int_distribution<int>(0, numNodes()-1);
     m_lastNodeId = static_cast<int>(m_nodes.size());
     m_edgeAttrsGen = std::move(edgeGen);
@@ -55,6 +60,24 @@ GraphType AbstractGraph::type() const
     return m_trial->graphType();
 }
 
+bool AbstractGraph::supportsImplicitEdges() const
+{
+    return false;
+}
+
+bool AbstractGraph::hasRandomTopology() const
+{
+    return true;
+}
+
+void AbstractGraph::neighbourIds(const int nodeId, std::vector<int>& ids) const
+{
+    ids.clear();
+    for (auto const& e : m_nodes.at(nodeId).outEdges()) {
+        ids.emplace_back(e.second.neighbour().id());
+    }
+}
+
 Node AbstractGraph::randNode() const
 {
     if (m_nodes.empty()) {
@@ -66,15 +89,17 @@ Node AbstractGraph::randNode() const
 Node AbstractGraph::addNode(Attributes attr, int x, int y)
 {
     QMutexLocker locker(&m_mutex);
+    m_topologyChanged = true;
     ++m_lastNodeId;
     Node node;
     BaseNode::constructor_key k;
     if (isDirected()) {
-        node.m_ptr = std::make_shared<DNode>(k, m_lastNodeId, attr, x, y);
+        node = Node(makeShared<DNode>(m_trial->m_arena, k, m_lastNodeId, attr, x, y));
     } else {
-        node.m_ptr = std::make_shared<UNode>(k, m_lastNodeId, attr, x, y);
+        node = Node(makeShared<UNode>(m_trial->m_arena, k, m_lastNodeId, attr, x, y));
     }
     m_nodes.insert({m_lastNodeId, node});
+    ++m_nodesVersion;
     m_numNodesDist = std::uniform_int_distribution<int>(0, numNodes()-1);
     return node;
 }
@@ -82,11 +107,13 @@ Node AbstractGraph::addNode(Attributes attr, int x, int y)
 Edge AbstractGraph::addEdge(const Node& origin, const Node& neighbour, Attributes* attrs)
 {
     QMutexLocker locker(&m_mutex);
+    m_topologyChanged = true;
+    ++m_edgesVersion;
     ++m_lastEdgeId;
     Edge edgeOut, edgeIn;
     BaseEdge::constructor_key k;
-    edgeOut.m_ptr = std::make_shared<BaseEdge>(k, m_lastEdgeId, origin, neighbour, attrs, true);
-    edgeIn.m_ptr = std::make_shared<BaseEdge>(k, m_lastEdgeId, neighbour, origin, attrs, false);
+    edgeOut.m_ptr = makeShared<BaseEdge>(m_trial->m_edgesArena, k, m_lastEdgeId, origin, neighbour, attrs, true);
+    edgeIn.m_ptr = makeShared<BaseEdge>(m_trial->m_edgesArena, k, m_lastEdgeId, neighbour, origin, attrs, false);
     origin.m_ptr->addOutEdge(edgeOut);
     neighbour.m_ptr->addInEdge(edgeIn); // neighbour must be aware of the in-connection
     m_edges.insert({m_lastEdgeId, edgeOut}); // store only the original direction
@@ -96,6 +123,8 @@ Edge AbstractGraph::addEdge(const Node& origin, const Node& neighbour, Attribute
 void AbstractGraph::removeAllEdges()
 {
     QMutexLocker locker(&m_mutex);
+    m_topologyChanged = true;
+    ++m_edgesVersion;
     for (auto const& p : m_nodes) {
         p.second.m_ptr->clearInEdges();
         p.second.m_ptr->clearOutEdges();
@@ -103,9 +132,19 @@ void AbstractGraph::removeAllEdges()
     m_edges.clear();
 }
 
+void AbstractGraph::resetEdges()
+{
+    removeAllEdges();
+    QMutexLocker locker(&m_mutex);
+    Edges().swap(m_edges);
+    m_lastEdgeId = -1;
+}
+
 void AbstractGraph::removeAllEdges(const Node& node)
 {
     QMutexLocker locker(&m_mutex);
+    m_topologyChanged = true;
+    ++m_edgesVersion;
     if (isUndirected()) {
         for (auto const& p : node.outEdges()) {
             p.second.neighbour().m_ptr->removeInEdge(p.first);
@@ -133,6 +172,7 @@ void AbstractGraph::removeNode(const Node& node)
     removeAllEdges(node);
     QMutexLocker locker(&m_mutex);
     m_nodes.erase(node.id());
+    ++m_nodesVersion;
     int sz = m_nodes.empty() ? 0 : numNodes()-1;
     m_numNodesDist = std::uniform_int_distribution<int>(0, sz);
 }
@@ -142,6 +182,7 @@ Nodes::iterator AbstractGraph::removeNode(Nodes::iterator it)
     removeAllEdges(it->second);
     QMutexLocker locker(&m_mutex);
     it = m_nodes.erase(it);
+    ++m_nodesVersion;
     int sz = m_nodes.empty() ? 0 : numNodes()-1;
     m_numNodesDist = std::uniform_int_distribution<int>(0, sz);
     return it;
@@ -150,6 +191,8 @@ Nodes::iterator AbstractGraph::removeNode(Nodes::iterator it)
 void AbstractGraph::removeEdge(const Edge& edge)
 {
     QMutexLocker locker(&m_mutex);
+    m_topologyChanged = true;
+    ++m_edgesVersion;
     edge.origin().m_ptr->removeOutEdge(edge.id());
     edge.neighbour().m_ptr->removeInEdge(edge.id());
     m_edges.erase(edge.id());
@@ -158,6 +201,8 @@ void AbstractGraph::removeEdge(const Edge& edge)
 Edges::iterator AbstractGraph::removeEdge(Edges::iterator it)
 {
     QMutexLocker locker(&m_mutex);
+    m_topologyChanged = true;
+    ++m_edgesVersion;
     const Edge& edge = it->second;
     edge.origin().m_ptr->removeOutEdge(edge.id());
     edge.neighbour().m_ptr->removeInEdge(edge.id());
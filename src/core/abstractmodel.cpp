@@ -18,7 +18,10 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QDebug>
+
 #include "abstractmodel.h"
+#include "modelplugin.h"
 #include "trial.h"
 
 namespace evoplex {
@@ -35,4 +38,88 @@ int AbstractModel::step() const
 int AbstractModel::lastStep() const
 { return m_trial->stopAt(); }
 
+const std::vector<Node>* AbstractModel::nodesIndex()
+{
+    // (re)built only when nodes are added or removed; the graph's version
+    // starts at 1 once its nodes are set, so it's always built the first time
+    const quint64 version = graph()->nodesVersion();
+    if (m_nodesIndexVersion != version) {
+        m_nodesIndexVersion = version;
+        m_nodesIndex.clear();
+        m_nodesIndex.reserve(nodes().size());
+        for (const Node& node : nodes()) {
+            m_nodesIndex.emplace_back(node);
+        }
+    }
+    return &m_nodesIndex;
+}
+
+NodeSequence AbstractModel::randomOrder()
+{
+    return NodeSequence(nodesIndex(), prg());
+}
+
+NodeSequence AbstractModel::randomDraws(int n)
+{
+    const std::vector<Node>* index = nodesIndex();
+    return NodeSequence(index, prg(), static_cast<quint64>(n < 0 ? index->size() : n));
+}
+
+int AbstractModel::nodeAttrId(const QString& name, Value::Type type,
+                              double lowest, double highest) const
+{
+    const AttributeRangePtr attrRange = m_trial->modelPlugin()->nodeAttrRange(name);
+    if (!attrRange) {
+        qWarning() << "the node's attribute" << name << "does not exist";
+        return -1;
+    }
+
+    Value::Type scopeType;
+    switch (attrRange->type()) {
+    case AttributeRange::Bool:
+        scopeType = Value::BOOL; break;
+    case AttributeRange::Int_Range:
+    case AttributeRange::Int_Set:
+        scopeType = Value::INT; break;
+    case AttributeRange::Double_Range:
+    case AttributeRange::Double_Set:
+        scopeType = Value::DOUBLE; break;
+    case AttributeRange::Invalid:
+        scopeType = Value::INVALID; break;
+    default:
+        scopeType = Value::STRING;
+    }
+
+    const int id = attrRange->id();
+    // the nodes might have been read from a file, so we also make sure
+    // that they agree with the scope
+    bool nodesMatch = true;
+    if (!nodes().empty()) {
+        const Attributes& attrs = nodes().cbegin()->second.attrs();
+        nodesMatch = id < attrs.size() && attrs.name(id) == name
+                     && attrs.value(id).type() == scopeType;
+    }
+    // a narrow T (e.g., qint8) must hold all the values of the range
+    bool fits = true;
+    if (scopeType == type && (type == Value::INT || type == Value::DOUBLE)) {
+        const double min = type == Value::INT ? attrRange->min().toInt()
+                                              : attrRange->min().toDouble();
+        const double max = type == Value::INT ? attrRange->max().toInt()
+                                              : attrRange->max().toDouble();
+        fits = min >= lowest && max <= highest;
+    }
+    if (scopeType != type || !fits || !nodesMatch) {
+        qWarning() << "the node's attribute" << name << "does not match the requested type";
+        return -1;
+    }
+    return id;
+}
+
+void AbstractModel::enableActiveSet()
+{
+    if (!m_activeSet) {
+        m_activeSet.reset(new ActiveSet());
+    }
+}
+
 } // evoplex
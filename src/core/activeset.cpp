@@ -0,0 +1,84 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "activeset.h"
+#include "edges.h"
+
+namespace evoplex {
+
+ActiveSet::ActiveSet()
+    : m_all(true)
+{
+}
+
+void ActiveSet::markDirty(const Node& node)
+{
+    if (!testAndSetBit(m_dirtyBits, node.id())) {
+        m_dirty.emplace_back(node);
+    }
+}
+
+void ActiveSet::keepActive(const Node& node)
+{
+    m_kept.emplace_back(node);
+}
+
+void ActiveSet::activate(const Node& node)
+{
+    if (!testAndSetBit(m_activeBits, node.id())) {
+        m_active.emplace_back(node);
+    }
+}
+
+void ActiveSet::advance(const Nodes& nodes)
+{
+    // clear the previous worklist; it keeps the capacity to avoid allocations
+    for (const Node& node : m_active) {
+        clearBit(m_activeBits, node.id());
+    }
+    m_active.clear();
+
+    if (m_all) {
+        m_all = false;
+        m_active.reserve(nodes.size());
+        for (const Node& node : nodes) {
+            activate(node);
+        }
+    } else {
+        for (const Node& node : m_kept) {
+            activate(node);
+        }
+        for (const Node& node : m_dirty) {
+            activate(node);
+            // the in-edges point to the nodes which have 'node' as neighbour
+            for (const Node& neighbour : node.inEdges()) {
+                activate(neighbour);
+            }
+        }
+    }
+
+    for (const Node& node : m_dirty) {
+        clearBit(m_dirtyBits, node.id());
+    }
+    m_dirty.clear();
+    m_kept.clear();
+}
+
+} // evoplex
@@ -0,0 +1,144 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arena.h"
+
+#include <cstdlib>
+#include <new>
+
+// Q_OS_LINUX is defined by the Qt headers included in arena.h
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>
+#endif
+
+namespace evoplex {
+
+#ifdef Q_OS_LINUX
+namespace {
+const size_t kHugePageSize = 2 * 1024 * 1024;
+}
+#endif
+
+Arena::Arena(size_t chunkSize)
+    : m_chunkSize(chunkSize),
+      m_cur(nullptr),
+      m_end(nullptr),
+      m_capacity(0),
+      m_freeLists(kMaxRecycledSize / kGranularity + 1, nullptr),
+      m_numFree(0),
+      m_recycling(true)
+{
+    Q_ASSERT(chunkSize > 0);
+}
+
+Arena::~Arena()
+{
+    for (void* chunk : m_chunks) {
+        std::free(chunk);
+    }
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    Q_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    auto align = [alignment](char* p) {
+        const quintptr mask = alignment - 1;
+        return reinterpret_cast<char*>((reinterpret_cast<quintptr>(p) + mask) & ~mask);
+    };
+
+    if (isRecyclable(size, alignment)) {
+        size = (size + kGranularity - 1) & ~(kGranularity - 1);
+        alignment = kGranularity;
+        if (m_numFree.load(std::memory_order_acquire) > 0) {
+            QMutexLocker locker(&m_freeMutex);
+            FreeBlock*& head = m_freeLists[size / kGranularity];
+            if (head) {
+                FreeBlock* block = head;
+                head = block->next;
+                m_numFree.fetch_sub(1, std::memory_order_relaxed);
+                return block;
+            }
+        }
+    }
+
+    if (m_cur) {
+        char* p = align(m_cur);
+        if (p + size <= m_end) {
+            m_cur = p + size;
+            return p;
+        }
+    }
+
+    // large objects get their own chunk, so that we don't waste
+    // the remaining space of the current one
+    if (size + alignment > m_chunkSize / 4) {
+        return align(static_cast<char*>(newChunk(size + alignment)));
+    }
+
+    char* chunk = static_cast<char*>(newChunk(m_chunkSize));
+    char* p = align(chunk);
+    m_cur = p + size;
+    m_end = chunk + m_chunkSize;
+    return p;
+}
+
+void Arena::deallocate(void* p, size_t size, size_t alignment)
+{
+    // the large objects are only released with the Arena
+    if (!p || !isRecyclable(size, alignment) ||
+            !m_recycling.load(std::memory_order_relaxed)) {
+        return;
+    }
+    size = (size + kGranularity - 1) & ~(kGranularity - 1);
+    QMutexLocker locker(&m_freeMutex);
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    block->next = m_freeLists[size / kGranularity];
+    m_freeLists[size / kGranularity] = block;
+    m_numFree.fetch_add(1, std::memory_order_release);
+}
+
+void* Arena::newChunk(size_t size)
+{
+    void* chunk = nullptr;
+#ifdef Q_OS_LINUX
+    if (size >= kHugePageSize) {
+        size = (size + kHugePageSize - 1) & ~(kHugePageSize - 1);
+        if (posix_memalign(&chunk, kHugePageSize, size) == 0) {
+#ifdef MADV_HUGEPAGE
+            madvise(chunk, size, MADV_HUGEPAGE);
+#endif
+        } else {
+            chunk = nullptr;
+        }
+    } else {
+        chunk = std::malloc(size);
+    }
+#else
+    chunk = std::malloc(size);
+#endif
+    if (!chunk) {
+        throw std::bad_alloc();
+    }
+    m_chunks.emplace_back(chunk);
+    m_capacity += size;
+    return chunk;
+}
+
+} // evoplex
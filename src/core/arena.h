@@ -0,0 +1,151 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <QMutex>
+#include <QtGlobal>
+
+namespace evoplex {
+
+class Arena;
+using ArenaPtr = std::shared_ptr<Arena>;
+
+/**
+ * @brief A bump allocator which releases all its memory at once.
+ *
+ * A trial creates millions of small objects (nodes, edges and their control
+ * blocks) which live as long as the graph. Allocating them from the global
+ * heap one by one is slow and fragments the heap across the worker threads.
+ * The Arena hands out memory from large chunks, which are only released when
+ * the Arena is destroyed. The small objects which are released before that
+ * (e.g., the edges removed by a model) are kept in free lists by size, and
+ * their memory is reused by the next objects of the same size.
+ *
+ * Only the objects themselves live in the Arena; the containers they own
+ * (e.g., the edge maps and attribute vectors of a node) still use the heap,
+ * so the destructors must run. When the whole Arena is about to be dropped,
+ * stopRecycling() turns deallocate() into a no-op, so the teardown does not
+ * pay for the free lists.
+ *
+ * On Linux, the chunks are aligned to 2MB and advised to be backed by
+ * transparent huge pages.
+ *
+ * @attention allocate() is not thread-safe; each trial owns its own Arena.
+ */
+class Arena
+{
+public:
+    explicit Arena(size_t chunkSize = 2 * 1024 * 1024);
+    ~Arena();
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // Gives back the memory of an object to be reused by allocate().
+    // It can be called from any thread, as the last reference to an object
+    // might be dropped anywhere (e.g., by the GUI).
+    void deallocate(void* p, size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // The memory released from now on is not recycled, it's only given back
+    // with the Arena. Call it before dropping all the objects at once.
+    inline void stopRecycling() { m_recycling.store(false, std::memory_order_relaxed); }
+
+    // number of bytes reserved from the system
+    inline size_t capacity() const { return m_capacity; }
+
+private:
+    // the small objects are recycled by size classes of kGranularity bytes,
+    // thus, they are aligned to kGranularity bytes
+    static const size_t kGranularity = 16;
+    static const size_t kMaxRecycledSize = 512;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    const size_t m_chunkSize;
+    std::vector<void*> m_chunks;
+    char* m_cur;
+    char* m_end;
+    size_t m_capacity;
+
+    QMutex m_freeMutex;
+    std::vector<FreeBlock*> m_freeLists; // by size class
+    std::atomic<size_t> m_numFree;       // blocks in the free lists
+    std::atomic<bool> m_recycling;
+
+    void* newChunk(size_t size);
+
+    static inline bool isRecyclable(size_t size, size_t alignment)
+    { return size > 0 && size <= kMaxRecycledSize && alignment <= kGranularity; }
+
+    Q_DISABLE_COPY(Arena)
+};
+
+/**
+ * @brief A std allocator which takes the memory from an Arena.
+ * It keeps the Arena alive, so the objects created with it (e.g., through
+ * std::allocate_shared) can safely outlive their trial.
+ */
+template<typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(ArenaPtr arena) : m_arena(std::move(arena)) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.arena()) {}
+
+    inline T* allocate(size_t n)
+    { return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))); }
+
+    inline void deallocate(T* p, size_t n)
+    { m_arena->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    inline const ArenaPtr& arena() const { return m_arena; }
+
+    template<typename U>
+    inline bool operator==(const ArenaAllocator<U>& o) const { return m_arena == o.arena(); }
+    template<typename U>
+    inline bool operator!=(const ArenaAllocator<U>& o) const { return m_arena != o.arena(); }
+
+private:
+    ArenaPtr m_arena;
+};
+
+// creates a shared object in the arena or in the heap if the arena is null
+template<typename T, typename... Args>
+inline std::shared_ptr<T> makeShared(const ArenaPtr& arena, Args&&... args)
+{
+    if (arena) {
+        return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+    }
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+} // evoplex
+#endif // ARENA_H
@@ -19,6 +19,7 @@
  */
 
 #include <cfloat>
+#include <cstdint>
 #include <QtDebug>
 #include <QFileInfo>
 
@@ -27,6 +28,51 @@
 namespace evoplex
 {
 
+namespace {
+
+// the limits of the integer types (e.g., 'int8');
+// returns false if 'prefix' is not an integer type
+bool intLimits(const QString& prefix, int& lo, int& hi)
+{
+    if (prefix == "int") { lo = INT32_MIN; hi = INT32_MAX; }
+    else if (prefix == "int8") { lo = INT8_MIN; hi = INT8_MAX; }
+    else if (prefix == "uint8") { lo = 0; hi = UINT8_MAX; }
+    else if (prefix == "int16") { lo = INT16_MIN; hi = INT16_MAX; }
+    else if (prefix == "uint16") { lo = 0; hi = UINT16_MAX; }
+    else { return false; }
+    return true;
+}
+
+inline bool isRealType(const QString& prefix)
+{ return prefix == "double" || prefix == "float"; }
+
+bool fitsIn(const QString& prefix, double v)
+{
+    const double limit = prefix == "float" ? FLT_MAX : DBL_MAX;
+    return v >= -limit && v <= limit;
+}
+
+// the prefix of the attrRangeStr implied by the type
+QString defaultTypeStr(AttributeRange::Type type)
+{
+    switch (type) {
+    case AttributeRange::Bool: return "bool";
+    case AttributeRange::Int_Range:
+    case AttributeRange::Int_Set: return "int";
+    case AttributeRange::Double_Range:
+    case AttributeRange::Double_Set: return "double";
+    default: return "string";
+    }
+}
+
+// rounds 'v' to the precision of the type
+double roundTo(const QString& prefix, double v)
+{
+    return prefix == "float" ? static_cast<float>(v) : v;
+}
+
+} // namespace
+
 AttributeRangePtr AttributeRange::parse(int attrId, const QString& attrName,
                                         const QString& attrRangeStr)
 {
@@ -60,28 +106,32 @@ AttributeRangePtr AttributeRange::parse(int attrId, const QString& attrName,
 AttributeRangePtr AttributeRange::setOfValues(QString attrRangeStr, const int id,
                                               const QString& attrName)
 {
-    QStringList valuesStr = attrRangeStr.remove("{").remove("}").split(",");
+    const int brace = attrRangeStr.indexOf('{');
+    const QString prefix = attrRangeStr.left(brace);
+    const QStringList valuesStr = attrRangeStr.mid(brace + 1).remove("}").split(",");
     Type type;
     Values values;
     values.reserve(static_cast<size_t>(valuesStr.size()));
     bool ok = false;
-    if (attrRangeStr.startsWith("int")) {
-        type = AttributeRange::Int_Set;
-        valuesStr[0] = valuesStr[0].remove("int");
+    int lo, hi;
+    if (isRealType(prefix)) {
+        type = AttributeRange::Double_Set;
         for (const QString& vStr : valuesStr) {
-            values.push_back(vStr.toInt(&ok));
+            const double v = vStr.toDouble(&ok);
+            ok = ok && fitsIn(prefix, v);
             if (!ok) break;
+            values.push_back(roundTo(prefix, v));
         }
-    } else if (attrRangeStr.startsWith("double")) {
-        type = AttributeRange::Double_Set;
-        valuesStr[0] = valuesStr[0].remove("double");
+    } else if (intLimits(prefix, lo, hi)) {
+        type = AttributeRange::Int_Set;
         for (const QString& vStr : valuesStr) {
-            values.push_back(vStr.toDouble(&ok));
+            const int v = vStr.toInt(&ok);
+            ok = ok && v >= lo && v <= hi;
             if (!ok) break;
+            values.push_back(v);
         }
-    } else if (attrRangeStr.startsWith("string")) {
+    } else if (prefix == "string") {
         type = AttributeRange::String_Set;
-        valuesStr[0] = valuesStr[0].remove("string");
         ok = true;
         for (const QString& vStr : valuesStr) {
             values.push_back(vStr);
@@ -93,7 +143,7 @@ AttributeRangePtr AttributeRange::setOfValues(QString attrRangeStr, const int id
     if (!ok) {
         return std::unique_ptr<SingleValue>(new SingleValue());
     }
-    return std::unique_ptr<SetOfValues>(new SetOfValues(id, attrName, type, values));
+    return std::unique_ptr<SetOfValues>(new SetOfValues(id, attrName, type, values, prefix));
 }
 
 AttributeRangePtr AttributeRange::intervalOfValues(QString attrRangeStr, const int id,
@@ -105,7 +155,9 @@ AttributeRangePtr AttributeRange::intervalOfValues(QString attrRangeStr, const i
                 AttributeRange::Bool, false, true));
     }
 
-    QStringList values = attrRangeStr.remove("[").remove("]").split(",");
+    const int bracket = attrRangeStr.indexOf('[');
+    const QString prefix = attrRangeStr.left(bracket);
+    const QStringList values = attrRangeStr.mid(bracket + 1).remove("]").split(",");
     if (values.size() != 2) {
         return std::unique_ptr<SingleValue>(new SingleValue());
     }
@@ -115,27 +167,36 @@ AttributeRangePtr AttributeRange::intervalOfValues(QString attrRangeStr, const i
     Value max;
     bool ok1 = false;
     bool ok2 = false;
+    int lo, hi;
 
-    if (attrRangeStr.startsWith("int")) {
-        type = AttributeRange::Int_Range;
-        values[0] = values[0].remove("int");
-        min = Value(values.at(0).toInt(&ok1));
+    if (isRealType(prefix)) {
+        type = AttributeRange::Double_Range;
+        const double dmin = values.at(0).toDouble(&ok1);
+        double dmax;
         if (values.at(1) == "max") {
-            max = Value(INT32_MAX);
+            dmax = prefix == "float" ? FLT_MAX : DBL_MAX;
             ok2 = true;
         } else {
-            max = Value(values.at(1).toInt(&ok2));
+            dmax = values.at(1).toDouble(&ok2);
         }
-    } else if (attrRangeStr.startsWith("double")) {
-        type = AttributeRange::Double_Range;
-        values[0] = values[0].remove("double");
-        min = Value(values.at(0).toDouble(&ok1));
+        ok1 = ok1 && fitsIn(prefix, dmin);
+        ok2 = ok2 && fitsIn(prefix, dmax);
+        min = Value(roundTo(prefix, dmin));
+        max = Value(roundTo(prefix, dmax));
+    } else if (intLimits(prefix, lo, hi)) {
+        type = AttributeRange::Int_Range;
+        const int imin = values.at(0).toInt(&ok1);
+        int imax;
         if (values.at(1) == "max") {
-            max = Value(DBL_MAX);
+            imax = hi;
             ok2 = true;
         } else {
-            max = Value(values.at(1).toDouble(&ok2));
+            imax = values.at(1).toInt(&ok2);
         }
+        ok1 = ok1 && imin >= lo && imin <= hi;
+        ok2 = ok2 && imax >= lo && imax <= hi;
+        min = Value(imin);
+        max = Value(imax);
     } else {
         return std::unique_ptr<SingleValue>(new SingleValue());
     }
@@ -144,7 +205,7 @@ AttributeRangePtr AttributeRange::intervalOfValues(QString attrRangeStr, const i
         return std::unique_ptr<SingleValue>(new SingleValue());
     }
     return std::unique_ptr<IntervalOfValues>(
-            new IntervalOfValues(id, attrName, type, min, max));
+            new IntervalOfValues(id, attrName, type, min, max, prefix));
 }
 
 Value AttributeRange::validate(const QString& valueStr) const
@@ -192,7 +253,7 @@ Value AttributeRange::validate(const QString& valueStr) const
     case Double_Range: {
         auto iov = dynamic_cast<const IntervalOfValues*>(this);
         bool ok = false;
-        Value value(valueStr.toDouble(&ok));
+        Value value(roundTo(m_typeStr, valueStr.toDouble(&ok)));
         if (ok && value.isValid() && value >= iov->min() &&
                 value <= iov->max()) {
             return value;
@@ -213,7 +274,7 @@ Value AttributeRange::validate(const QString& valueStr) const
     case Double_Set: {
         auto sov = dynamic_cast<const SetOfValues*>(this);
         bool ok = false;
-        Value value(valueStr.toDouble(&ok));
+        Value value(roundTo(m_typeStr, valueStr.toDouble(&ok)));
         if (ok && value.isValid()) {
             for (const Value& validValue : sov->values()) {
                 if (value == validValue) return value;
@@ -242,10 +303,12 @@ Value AttributeRange::validate(const QString& valueStr) const
 
 /**********************************/
 
-AttributeRange::AttributeRange(int id, const QString& attrName, Type type)
+AttributeRange::AttributeRange(int id, const QString& attrName, Type type,
+                               const QString& typeStr)
     : m_id(id)
     , m_attrName(attrName)
     , m_type(type)
+    , m_typeStr(!typeStr.isEmpty() ? typeStr : defaultTypeStr(type))
 {
 }
 
@@ -283,8 +346,8 @@ SingleValue::SingleValue()
 /**********************************/
 
 IntervalOfValues::IntervalOfValues(int id, const QString& attrName, Type type,
-                                   const Value& min, const Value& max)
-    : AttributeRange(id, attrName, type)
+                                   const Value& min, const Value& max, const QString& typeStr)
+    : AttributeRange(id, attrName, type, typeStr)
 {
     m_min = min;
     m_max = max;
@@ -299,24 +362,26 @@ IntervalOfValues::IntervalOfValues(int id, const QString& attrName, Type type,
         break;
     case Double_Range:
         Q_ASSERT(min.isDouble() && max.isDouble());
-        m_attrRangeStr = QString("double[%1,%2]").arg(min.toDouble()).arg(max.toDouble());
-        f_rand = [this](PRG* prg) { return prg->uniform(m_min.toDouble(), m_max.toDouble()); };
-        f_next = [max, min](const Value& v) {
+        m_attrRangeStr = QString("%1[%2,%3]").arg(typeStr()).arg(min.toDouble()).arg(max.toDouble());
+        f_rand = [this](PRG* prg) {
+            return roundTo(m_typeStr, prg->uniform(m_min.toDouble(), m_max.toDouble()));
+        };
+        f_next = [this, max, min](const Value& v) {
             if (v.type() != Value::DOUBLE || v > max || v < min) return v;
             if (v == max) return min;
-            double n = v.toDouble() + 1.0;
+            double n = roundTo(m_typeStr, v.toDouble() + 1.0);
             return n > max.toDouble() ? max : n;
         };
-        f_prev = [max, min](const Value& v) {
+        f_prev = [this, max, min](const Value& v) {
             if (v.type() != Value::DOUBLE || v > max || v < min) return v;
             if (v == min) return max;
-            double n = v.toDouble() - 1.0;
+            double n = roundTo(m_typeStr, v.toDouble() - 1.0);
             return n < min.toDouble() ? min : n;
         };
         break;
     case Int_Range:
         Q_ASSERT(min.isInt() && max.isInt());
-        m_attrRangeStr = QString("int[%1,%2]").arg(min.toInt()).arg(max.toInt());
+        m_attrRangeStr = QString("%1[%2,%3]").arg(typeStr()).arg(min.toInt()).arg(max.toInt());
         f_rand = [this](PRG* prg) { return prg->uniform(m_min.toInt(), m_max.toInt()); };
         f_next = [max, min](const Value& v) {
             if (v.type() != Value::INT || v > max || v < min) return v;
@@ -339,8 +404,9 @@ IntervalOfValues::IntervalOfValues(int id, const QString& attrName, Type type,
 
 /**********************************/
 
-SetOfValues::SetOfValues(int id, const QString& attrName, Type type, Values values)
-    : AttributeRange(id, attrName, type)
+SetOfValues::SetOfValues(int id, const QString& attrName, Type type, Values values,
+                         const QString& typeStr)
+    : AttributeRange(id, attrName, type, typeStr)
     , m_values(values)
 {
     m_min = (*std::min_element(m_values.cbegin(), m_values.cend()));
@@ -350,11 +416,11 @@ SetOfValues::SetOfValues(int id, const QString& attrName, Type type, Values valu
     switch (m_type) {
     case Double_Set:
         for (auto const& v : values) Q_ASSERT(v.type() == Value::DOUBLE);
-        m_attrRangeStr = "double{";
+        m_attrRangeStr = typeStr() + "{";
         break;
     case Int_Set:
         for (auto const& v : values) Q_ASSERT(v.type() == Value::INT);
-        m_attrRangeStr = "int{";
+        m_attrRangeStr = typeStr() + "{";
         break;
     case String_Set:
         for (auto const& v : values) Q_ASSERT(v.type() == Value::STRING);
@@ -30,6 +30,11 @@
 
 namespace evoplex {
 
+namespace {
+// maximum number of entries in the lookup table of ints
+const qint64 kMaxLutSize = 1 << 16;
+}
+
 ColorMapMgr::ColorMapMgr()
     : m_dfCMap("Black", 1)
 {
@@ -128,7 +133,12 @@ ColorMap* ColorMap::create(AttributeRangePtr attrRange, const Colors& colors)
 
 ColorMap::ColorMap(AttributeRangePtr attrRange, const Colors& colors)
     : m_attrRange(attrRange),
-      m_colors(colors)
+      m_colors(colors),
+      m_singleColor(false),
+      m_lutType(Value::INVALID),
+      m_lutMin(0),
+      m_binsMax(0.f),
+      m_binsMin(0.f)
 {
     Q_ASSERT_X(colors.size() > 0, "ColorMap", "the color size is invalid!");
 }
@@ -137,11 +147,66 @@ ColorMap::~ColorMap()
 {
 }
 
+void ColorMap::compileLut()
+{
+    m_lut.clear();
+    m_lutType = Value::INVALID;
+    m_lutMin = 0;
+    if (m_singleColor) {
+        m_lut.emplace_back(m_colors.front().rgba());
+        return;
+    }
+
+    try {
+        if (m_attrRange->type() == AttributeRange::Bool) {
+            m_lut = { colorFromValue(Value(false)).rgba(),
+                      colorFromValue(Value(true)).rgba() };
+            m_lutType = Value::BOOL;
+        } else if (m_attrRange->min().type() == Value::INT &&
+                   m_attrRange->max().type() == Value::INT) {
+            const qint64 min = m_attrRange->min().toInt();
+            const qint64 max = m_attrRange->max().toInt();
+            if (max - min >= kMaxLutSize) {
+                return; // too sparse; let's use colorFromValue()
+            }
+            m_lutMin = min;
+            m_lut.reserve(static_cast<size_t>(max - min + 1));
+            for (qint64 v = min; v <= max; ++v) {
+                m_lut.emplace_back(colorFromValue(Value(static_cast<int>(v))).rgba());
+            }
+            m_lutType = Value::INT;
+        }
+    } catch (std::out_of_range) {
+        // the colormap can't handle the whole range; let's not use a lut
+        m_lut.clear();
+        m_lutType = Value::INVALID;
+        m_lutMin = 0;
+    }
+}
+
+void ColorMap::rgb(const Values& values, std::vector<QRgb>& out) const
+{
+    out.resize(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (!values[i].isValid()) {
+            out[i] = 0;
+            continue;
+        }
+        try {
+            out[i] = rgb(values[i]);
+        } catch (std::out_of_range) {
+            out[i] = 0;
+        }
+    }
+}
+
 /************************************************************************/
 
 SingleColor::SingleColor(AttributeRangePtr attrRange, QColor color)
     : ColorMap(attrRange, {color})
 {
+    m_singleColor = true;
+    compileLut();
 }
 
 const QColor& SingleColor::colorFromValue(const Value& val) const
@@ -173,6 +238,14 @@ ColorMapRange::ColorMapRange(AttributeRangePtr attrRange, const Colors& colors)
     } else {
         qFatal("invalid attribute range!");
     }
+
+    m_binsMax = m_max;
+    m_binsMin = m_min;
+    m_bins.reserve(m_colors.size());
+    for (const QColor& c : m_colors) {
+        m_bins.emplace_back(c.rgba());
+    }
+    compileLut();
 }
 
 const QColor& ColorMapRange::colorFromValue(const Value& val) const
@@ -203,6 +276,7 @@ ColorMapSet::ColorMapSet(AttributeRangePtr attrRange, const Colors& colors)
         m_cmap.insert({value, m_colors.at(c++)});
         c = (c == m_colors.size()) ? 0 : c;
     }
+    compileLut();
 }
 
 const QColor& ColorMapSet::colorFromValue(const Value& val) const
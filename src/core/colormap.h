@@ -22,7 +22,9 @@
 #define COLORMAP_H
 
 #include <QColor>
+#include <QRgb>
 #include <QSettings>
+#include <cmath>
 #include <unordered_map>
 #include <vector>
 
@@ -34,6 +36,9 @@ namespace evoplex {
 using Colors = std::vector<QColor>;
 using CMapKey = QPair<QString, int>; // <name,size>
 
+// The colour maps read from the resource ':colormaps/colormaps.json', which
+// is built into the application, and the user's default one. Without that
+// resource (e.g., in the unit tests), only 'Black' is available.
 class ColorMapMgr
 {
 public:
@@ -70,12 +75,65 @@ public:
     inline const AttributeRangePtr& attrRange() const { return m_attrRange; }
     inline const Colors& colors() const { return m_colors; }
 
+    // The ARGB of the value, i.e., the same as colorFromValue(), but looked
+    // up in the tables compiled in the constructor: bools and ints are a
+    // direct index and doubles are quantised into the bins of the colours.
+    // Any other value falls back to colorFromValue().
+    inline QRgb rgb(const Value& val) const;
+
+    // Maps a column of values (e.g., a snapshot of the nodes) to 'out'.
+    // Invalid values are mapped to 0, i.e., transparent.
+    void rgb(const Values& values, std::vector<QRgb>& out) const;
+
 protected:
     explicit ColorMap(AttributeRangePtr attrRange, const Colors& colors);
     AttributeRangePtr m_attrRange;
     Colors m_colors;
+
+    // must be called at the end of the constructor of the subclasses
+    void compileLut();
+
+    bool m_singleColor;
+    std::vector<QRgb> m_lut;  // bools or ints, indexed by 'value - m_lutMin'
+    Value::Type m_lutType;    // BOOL, INT or INVALID (no lut)
+    qint64 m_lutMin;
+    std::vector<QRgb> m_bins; // doubles, see binOf()
+    float m_binsMax;
+    float m_binsMin;
+
+    inline size_t binOf(double value) const;
 };
 
+inline QRgb ColorMap::rgb(const Value& val) const
+{
+    if (m_singleColor) {
+        return m_lut.front();
+    }
+
+    size_t i = m_lut.size();
+    if (val.type() == m_lutType) {
+        const qint64 v = m_lutType == Value::INT ? val.toInt() : val.toBool();
+        i = static_cast<size_t>(v - m_lutMin);
+    } else if (val.type() == Value::DOUBLE && !m_bins.empty()) {
+        const size_t b = binOf(val.toDouble());
+        if (b < m_bins.size()) {
+            return m_bins[b];
+        }
+    }
+    if (i < m_lut.size()) {
+        return m_lut[i];
+    }
+    return colorFromValue(val).rgba(); // it might throw out_of_range
+}
+
+inline size_t ColorMap::binOf(double value) const
+{
+    // the same arithmetic as ColorMapRange::colorFromValue()
+    const float v = static_cast<float>(value);
+    const float b = std::round((v * (m_bins.size() - 1)) / m_binsMax) + m_binsMin;
+    return b >= 0.f && b < m_bins.size() ? static_cast<size_t>(b) : m_bins.size();
+}
+
 /************************************************************************/
 
 class SingleColor : public ColorMap
@@ -40,6 +40,7 @@ class BaseEdge
 {
     friend class AbstractGraph;
     friend class TestEdge;
+    friend class TestForceLayout;
 
 private:
     struct constructor_key { /* this is a private key accessible only to friends */ };
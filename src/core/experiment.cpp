@@ -19,6 +19,7 @@
  */
 
 #include <QDebug>
+#include <QFileInfo>
 
 #include "experiment.h"
 #include "nodes.h"
@@ -38,6 +39,13 @@ Experiment::Experiment(MainApp* mainApp, const int id, ProjectWPtr project)
       m_numTrials(0),
       m_autoDeleteTrials(true),
       m_stopAt(-1),
+      m_outputStartAt(0),
+      m_outputInterval(1),
+      m_outputSaveSteps(0),
+      m_outputAvgTrials(false),
+      m_outputFramesInterval(1),
+      m_steadyState(0),
+      m_steadyStatePad(false),
       m_pauseAt(-1),
       m_progress(0),
       m_delay(0),
@@ -109,6 +117,38 @@ bool Experiment::setInputs(ExpInputsPtr inputs, QString& error)
     setStopAt(m_inputs->general(GENERAL_ATTR_STOPAT).toInt());
     setPauseAt(m_stopAt);
 
+    // optional attributes; invalid values fall back to the defaults,
+    // ie., outputs at every step and no steady-state detection
+    auto intAttr = [this](const char* name, int defaultValue) {
+        const Value v = m_inputs->general(name);
+        return v.isInt() ? v.toInt() : defaultValue;
+    };
+    auto boolAttr = [this](const char* name) {
+        const Value v = m_inputs->general(name);
+        return v.isBool() && v.toBool();
+    };
+    m_outputStartAt = intAttr(OUTPUT_STARTAT, 0);
+    m_outputInterval = qMax(1, intAttr(OUTPUT_INTERVAL, 1));
+    m_outputSaveSteps = intAttr(OUTPUT_SAVESTEPS, 0);
+    m_outputAvgTrials = boolAttr(OUTPUT_AVGTRIALS);
+    m_outputFrames = m_inputs->general(OUTPUT_FRAMES).isString()
+            ? m_inputs->general(OUTPUT_FRAMES).toQString() : QString();
+    m_outputFramesInterval = qMax(1, intAttr(OUTPUT_FRAMESINTERVAL, 1));
+    m_steadyState = qMax(0, intAttr(GENERAL_ATTR_STEADYSTATE, 0));
+    m_steadyStatePad = boolAttr(GENERAL_ATTR_STEADYPAD);
+
+    if (!m_outputFrames.isEmpty()) {
+        const QFileInfo outDir(m_inputs->general(OUTPUT_DIR).toQString());
+        if (!modelPlugin()->nodeAttrRange(m_outputFrames)) {
+            error += QString("unable to record '%1': it is not a node attribute!\n")
+                     .arg(m_outputFrames);
+            m_expStatus = Status::Invalid;
+        } else if (!outDir.isDir() || !outDir.isWritable()) {
+            error += "The output directory must be valid and writable!\n";
+            m_expStatus = Status::Invalid;
+        }
+    }
+
     if (!error.isEmpty()) {
         qWarning() << error;
     }
@@ -133,8 +173,10 @@ bool Experiment::disable(QString* error)
     m_mainApp->expMgr()->remove(shared_from_this());
 
     deleteTrials();
+    m_aggregator.reset();
     m_outputs.clear();
     m_filePathPrefix.clear();
+    m_avgFilePath.clear();
     m_fileHeader.clear();
     m_expStatus = Status::Disabled;
     setProgress(0);
@@ -169,10 +211,38 @@ bool Experiment::reset(QString* error)
         o->flushAll();
     }
 
-    deleteTrials();
-    m_trials.reserve(static_cast<size_t>(m_numTrials));
-    for (quint16 trialId = 0; trialId < m_numTrials; ++trialId) {
-        m_trials.insert({trialId, new Trial(trialId, shared_from_this())});
+    m_aggregator.reset();
+    if (m_outputAvgTrials && !m_avgFilePath.isEmpty()) {
+        m_aggregator.reset(new TrialsAggregator(m_avgFilePath, m_numTrials));
+        if (!m_aggregator->init(m_fileHeader, erroMsg)) {
+            m_aggregator.reset();
+            qWarning() << erroMsg;
+            if (error) *error = erroMsg;
+            return false;
+        }
+    }
+
+    // the existing trials are rewound, i.e., they keep their graphs and
+    // only restore the nodes' attributes and the PRG (see Trial::rewind)
+    bool rewind = m_trials.size() == static_cast<size_t>(m_numTrials);
+    if (rewind && m_clonableNodes.empty()) {
+        // the initial population was released once all trials were created
+        m_clonableNodes = createNodes();
+        rewind = !m_clonableNodes.empty();
+    }
+    if (rewind) {
+        for (auto& trial : m_trials) {
+            if (!trial.second->rewind()) {
+                delete trial.second;
+                trial.second = new Trial(trial.first, shared_from_this());
+            }
+        }
+    } else {
+        deleteTrials();
+        m_trials.reserve(static_cast<size_t>(m_numTrials));
+        for (quint16 trialId = 0; trialId < m_numTrials; ++trialId) {
+            m_trials.insert({trialId, new Trial(trialId, shared_from_this())});
+        }
     }
 
     m_expStatus = Status::Paused;
@@ -204,9 +274,23 @@ void Experiment::enable(QString& error)
 
     m_outputs.clear();
     m_fileHeader.clear();
-    for (const Cache* cache : m_inputs->fileCaches()) {
-        m_fileHeader += cache->printableHeader(',', false) + ",";
-        m_outputs.insert(cache->output());
+    if (m_outputAvgTrials) {
+        // a single file for all trials; each column becomes a set of statistics
+        m_avgFilePath = QString("%1/%2_e%3_avg.csv")
+                .arg(m_inputs->general(OUTPUT_DIR).toQString(), project->name())
+                .arg(m_id);
+        m_fileHeader = "step,trials,";
+        for (const Cache* cache : m_inputs->fileCaches()) {
+            for (const QString& col : cache->printableHeader(',', false).split(',')) {
+                m_fileHeader += TrialsAggregator::printableHeader(col, ',') + ",";
+            }
+            m_outputs.insert(cache->output());
+        }
+    } else {
+        for (const Cache* cache : m_inputs->fileCaches()) {
+            m_fileHeader += cache->printableHeader(',', false) + ",";
+            m_outputs.insert(cache->output());
+        }
     }
     m_fileHeader.chop(1);
     m_fileHeader += "\n";
@@ -269,6 +353,12 @@ void Experiment::expFinished()
     }
 
     if (allTrialsFinished) {
+        // trials which stopped earlier may have left incomplete rows behind
+        if (m_aggregator && !m_aggregator->writeRows(true)) {
+            m_expStatus = Status::Invalid;
+            emit (statusChanged(m_expStatus));
+            return;
+        }
         m_expStatus = Status::Finished;
         if (m_autoDeleteTrials) {
             locker.unlock();
@@ -317,17 +407,15 @@ void Experiment::playNext()
     play();
 }
 
-Nodes Experiment::cloneCachedNodes(const int trialId)
+Nodes Experiment::cloneCachedNodes(const int trialId, const ArenaPtr& arena)
 {
     if (m_clonableNodes.empty()) {
         return Nodes();
     }
 
     // if it's not the last trial, just take a copy of the nodes
-    for (auto const& it : m_trials) {
-        if (it.first != trialId && it.second->status() == Status::Disabled) {
-            return NodesPrivate::clone(m_clonableNodes);
-        }
+    if (hasTrialsToInit(trialId)) {
+        return NodesPrivate::clone(m_clonableNodes, arena);
     }
 
     // it's the last trial, let's use the cloned nodes
@@ -336,6 +424,23 @@ Nodes Experiment::cloneCachedNodes(const int trialId)
     return nodes;
 }
 
+void Experiment::releaseCachedNodes(const int trialId)
+{
+    if (!hasTrialsToInit(trialId)) {
+        Nodes().swap(m_clonableNodes);
+    }
+}
+
+bool Experiment::hasTrialsToInit(const int trialId) const
+{
+    for (auto const& it : m_trials) {
+        if (it.first != trialId && it.second->status() == Status::Disabled) {
+            return true;
+        }
+    }
+    return false;
+}
+
 AttrsGeneratorPtr Experiment::edgeAttrsGen(bool& ok) const
 {
     ok = true;
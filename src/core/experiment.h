@@ -28,6 +28,7 @@
 
 #include <QMutex>
 
+#include "arena.h"
 #include "attrsgenerator.h"
 #include "constants.h"
 #include "enum.h"
@@ -98,6 +99,27 @@ public:
     inline quint16 delay() const;
     inline void setDelay(quint16 delay);
 
+    // true if the outputs must be evaluated at a specific step, i.e.,
+    // 'step' is after OUTPUT_STARTAT and matches the OUTPUT_INTERVAL
+    inline bool isOutputStep(int step) const;
+
+    // number of steps kept in the file outputs; 0 to keep all steps
+    inline int outputSaveSteps() const;
+
+    // true if the file outputs of all trials are merged into a single
+    // summary file (mean, variance, min, max and median of each column)
+    inline bool outputAvgTrials() const;
+
+    // name of the node attribute saved as images every OUTPUT_FRAMESINTERVAL
+    // steps; empty if the trials are not recorded (see FrameRecorder)
+    inline const QString& outputFrames() const;
+    inline int outputFramesInterval() const;
+
+    // max length of the cycles detected by the trials; 0 if disabled
+    // (see GENERAL_ATTR_STEADYSTATE)
+    inline int steadyState() const;
+    inline bool steadyStatePad() const;
+
     inline bool autoDeleteTrials() const;
     inline void setAutoDeleteTrials(bool b);
 
@@ -154,9 +176,19 @@ private:
     int m_numTrials;
     bool m_autoDeleteTrials;
     int m_stopAt;
+    int m_outputStartAt;
+    int m_outputInterval;
+    int m_outputSaveSteps;
+    bool m_outputAvgTrials;
+    QString m_outputFrames;
+    int m_outputFramesInterval;
+    int m_steadyState;
+    bool m_steadyStatePad;
 
     QString m_fileHeader;   // file header is the same for all trials; let's save it then
     QString m_filePathPrefix;
+    QString m_avgFilePath;
+    std::unique_ptr<TrialsAggregator> m_aggregator; // only if OUTPUT_AVGTRIALS is enabled
     std::unordered_set<OutputPtr> m_outputs;
 
     int m_pauseAt;
@@ -170,16 +202,26 @@ private:
     // So, considering that it might be a very expensive operation (eg, I/O),
     // we try to do the heavy stuff only once, storing the initial population
     // in the 'm_clonableNodes' container. Except when the experiment has only
-    // one trial.
+    // one trial. It is released once all trials are created, and it is only
+    // created again when the trials are rewound (see reset()).
     Nodes m_clonableNodes;
 
     // Parse the edge attrs command and return an AttrsGenerator
     AttrsGeneratorPtr edgeAttrsGen(bool& ok) const;
 
-    // Return a clone of 'm_clonableNodes'. It also clear the 'm_clonableNodes'
-    // if 'trialId' is the last trial being created for this experiment.
+    // Return a clone of 'm_clonableNodes' (allocated in the arena). It also
+    // clear the 'm_clonableNodes' if 'trialId' is the last trial being created
+    // for this experiment.
+    // This method is NOT thread-safe.
+    Nodes cloneCachedNodes(const int trialId, const ArenaPtr& arena);
+
+    // Clear the 'm_clonableNodes' if 'trialId' is the last trial being
+    // created or rewound for this experiment.
     // This method is NOT thread-safe.
-    Nodes cloneCachedNodes(const int trialId);
+    void releaseCachedNodes(const int trialId);
+
+    // true if any trial other than 'trialId' is yet to be initialized
+    bool hasTrialsToInit(const int trialId) const;
 
     void deleteTrials();
 
@@ -239,6 +281,27 @@ inline quint16 Experiment::delay() const
 inline void Experiment::setDelay(quint16 delay)
 { m_delay = delay; }
 
+inline bool Experiment::isOutputStep(int step) const
+{ return step >= m_outputStartAt && (step - m_outputStartAt) % m_outputInterval == 0; }
+
+inline int Experiment::outputSaveSteps() const
+{ return m_outputSaveSteps; }
+
+inline bool Experiment::outputAvgTrials() const
+{ return m_outputAvgTrials; }
+
+inline const QString& Experiment::outputFrames() const
+{ return m_outputFrames; }
+
+inline int Experiment::outputFramesInterval() const
+{ return m_outputFramesInterval; }
+
+inline int Experiment::steadyState() const
+{ return m_steadyState; }
+
+inline bool Experiment::steadyStatePad() const
+{ return m_steadyStatePad; }
+
 inline bool Experiment::autoDeleteTrials() const
 { return m_autoDeleteTrials; }
 
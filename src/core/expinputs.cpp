@@ -108,6 +108,7 @@ ExpInputsPtr ExpInputs::parse(const MainApp* mainApp, const QStringList& header,
 
     QStringList failedAttrs;
     parseAttrs(ei.get(), mainApp, header, values, failedAttrs);
+    fillOptionalAttrs(ei.get(), mainApp);
     parseFileCache(ei.get(), failedAttrs, errMsg);
 
     // make sure all attributes exist
@@ -239,6 +240,30 @@ void ExpInputs::parseAttrs(ExpInputs* ei, const MainApp* mainApp, const QStringL
     }
 }
 
+void ExpInputs::fillOptionalAttrs(ExpInputs* ei, const MainApp* mainApp)
+{
+    // projects created with older versions do not have these columns;
+    // the defaults keep the previous behaviour
+    const std::vector<std::pair<QString, Value>> optionalAttrs {
+        {GENERAL_ATTR_STEADYSTATE, Value(0)},
+        {GENERAL_ATTR_STEADYPAD, Value(false)},
+        {OUTPUT_STARTAT, Value(0)},
+        {OUTPUT_INTERVAL, Value(1)},
+        {OUTPUT_SAVESTEPS, Value(0)},
+        {OUTPUT_AVGTRIALS, Value(false)},
+        {OUTPUT_FRAMES, Value("")},
+        {OUTPUT_FRAMESINTERVAL, Value(1)}
+    };
+
+    for (auto const& attr : optionalAttrs) {
+        if (!ei->m_generalAttrs->contains(attr.first)) {
+            auto attrRange = mainApp->generalAttrsScope().value(attr.first);
+            Q_ASSERT(attrRange);
+            ei->m_generalAttrs->replace(attrRange->id(), attr.first, attr.second);
+        }
+    }
+}
+
 void ExpInputs::parseFileCache(ExpInputs* ei, QStringList& failedAttrs, QString& errMsg)
 {
     QString outHeader = ei->m_generalAttrs->value(OUTPUT_HEADER, Value("")).toQString();
@@ -257,6 +282,12 @@ void ExpInputs::parseFileCache(ExpInputs* ei, QStringList& failedAttrs, QString&
             failedAttrs.append(OUTPUT_HEADER);
         }
 
+        // keep only the last n rows in memory; they're written at the end
+        const int saveSteps = ei->m_generalAttrs->value(OUTPUT_SAVESTEPS, Value(0)).toInt();
+        for (Cache* cache : ei->m_fileCaches) {
+            cache->setMaxRows(saveSteps);
+        }
+
         QFileInfo outDir(ei->m_generalAttrs->value(OUTPUT_DIR, Value("")).toQString());
         if (!outDir.isDir() || !outDir.isWritable()) {
             errMsg += "The output directory must be valid and writable!\n";
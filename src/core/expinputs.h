@@ -80,6 +80,10 @@ private:
     static void parseAttrs(ExpInputs* ei, const MainApp* mainApp,
             const QStringList& header, const QStringList& values, QStringList& failedAttrs);
 
+    // Some general attributes are optional (e.g., the output schedule).
+    // If they are missing, they are filled with their default values.
+    static void fillOptionalAttrs(ExpInputs* ei, const MainApp* mainApp);
+
     static void parseFileCache(ExpInputs* ei, QStringList& failedAttrs, QString& errMsg);
 
     static void checkAttrCommands(ExpInputs* ei, QStringList& failedAttrs);
@@ -0,0 +1,325 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <QtConcurrent>
+
+#include "forcelayout.h"
+#include "prg.h"
+
+namespace evoplex {
+
+namespace {
+// a cell as seen from a node acts as a single node if side/distance < kTheta
+const float kTheta = 1.2f;
+// the cells are not split beyond this depth (i.e., coincident nodes)
+const int kMaxDepth = 24;
+// squared distances are at least this, so the repulsion is bounded
+const float kMinDistance2 = 1e-4f;
+// the temperature at the end of each iteration is multiplied by this
+const float kCooling = 0.95f;
+// the number of nodes computed by each parallel job (see m_order)
+const int kChunkSize = 4096;
+}
+
+ForceLayout::ForceLayout(const Nodes& nodes, unsigned int seed)
+    : m_iterations(0),
+      m_minTemperature(0.01f)
+{
+    m_nodes.reserve(nodes.size());
+    int maxId = -1;
+    for (auto const& p : nodes) {
+        m_nodes.emplace_back(p.second);
+        maxId = std::max(maxId, p.first);
+    }
+    // the same graph is laid out the same way, whatever the hashing order
+    std::sort(m_nodes.begin(), m_nodes.end(),
+              [](const Node& a, const Node& b) { return a.id() < b.id(); });
+
+    const int n = static_cast<int>(m_nodes.size());
+    std::vector<int> indexOf(static_cast<size_t>(maxId + 1), -1);
+    for (int i = 0; i < n; ++i) {
+        indexOf[static_cast<size_t>(m_nodes[i].id())] = i;
+    }
+
+    // the neighbours of each node in a compressed sparse row;
+    // the edges pull both of their nodes, whatever their direction
+    auto forEachNeighbour = [&indexOf](const Node& node, auto func) {
+        auto visit = [&indexOf, &node, &func](const Edges& edges) {
+            for (auto const& ep : edges) {
+                const int j = ep.second.neighbour().id();
+                if (j != node.id() && j >= 0 && j < static_cast<int>(indexOf.size())
+                        && indexOf[static_cast<size_t>(j)] >= 0) {
+                    func(indexOf[static_cast<size_t>(j)]);
+                }
+            }
+        };
+        visit(node.outEdges());
+        if (&node.inEdges() != &node.outEdges()) { // directed
+            visit(node.inEdges());
+        }
+    };
+    m_offsets.resize(static_cast<size_t>(n + 1), 0);
+    for (int i = 0; i < n; ++i) {
+        int degree = 0;
+        forEachNeighbour(m_nodes[i], [&degree](int) { ++degree; });
+        m_offsets[i + 1] = m_offsets[i] + degree;
+    }
+    m_neighbours.resize(static_cast<size_t>(m_offsets[n]));
+    for (int i = 0; i < n; ++i) {
+        int k = m_offsets[i];
+        forEachNeighbour(m_nodes[i], [this, &k](int j) { m_neighbours[k++] = j; });
+    }
+
+    // random positions over an area of 'n', i.e., 1 per node
+    const float side = std::sqrt(static_cast<float>(std::max(n, 1)));
+    PRG prg(seed);
+    m_x.resize(static_cast<size_t>(n));
+    m_y.resize(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        m_x[i] = prg.uniform(0.f, side);
+        m_y[i] = prg.uniform(0.f, side);
+    }
+    m_dx.resize(static_cast<size_t>(n));
+    m_dy.resize(static_cast<size_t>(n));
+    m_temperature = n > 0 ? side / 10.f : 0.f; // nothing to do if empty
+
+    for (int i = 0; i < n; i += kChunkSize) {
+        m_chunks.emplace_back(i, std::min(i + kChunkSize, n));
+    }
+    m_cells.reserve(static_cast<size_t>(2 * n + 1));
+    m_order.reserve(static_cast<size_t>(n));
+}
+
+bool ForceLayout::iterate(int iterations)
+{
+    for (int it = 0; it < iterations && !isDone(); ++it) {
+        buildTree();
+        // each job reads the tree and the positions and writes
+        // the displacement of its own nodes only
+        QtConcurrent::blockingMap(m_chunks, [this](const std::pair<int,int>& chunk) {
+            computeForces(chunk.first, chunk.second);
+        });
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            m_x[i] += m_dx[i];
+            m_y[i] += m_dy[i];
+        }
+        m_temperature *= kCooling;
+        ++m_iterations;
+    }
+    return isDone();
+}
+
+void ForceLayout::apply() const
+{
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        Node(m_nodes[i]).setCoords(m_x[i], m_y[i]);
+    }
+}
+
+bool ForceLayout::lacksCoords(const Nodes& nodes)
+{
+    if (nodes.size() < 2) {
+        return false;
+    }
+    for (auto const& p : nodes) {
+        if (p.second.hasCoords()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ForceLayout::buildTree()
+{
+    const auto xs = std::minmax_element(m_x.cbegin(), m_x.cend());
+    const auto ys = std::minmax_element(m_y.cbegin(), m_y.cend());
+    const float half = std::max(*xs.second - *xs.first, *ys.second - *ys.first) / 2.f + 1e-3f;
+
+    m_cells.clear();
+    Cell root;
+    root.x = root.y = root.mass = 0.f;
+    root.cx = (*xs.first + *xs.second) / 2.f;
+    root.cy = (*ys.first + *ys.second) / 2.f;
+    root.half = half;
+    std::fill(root.child, root.child + 4, -1);
+    root.node = -1;
+    m_cells.emplace_back(root);
+
+    const int n = static_cast<int>(m_nodes.size());
+    for (int i = 0; i < n; ++i) {
+        insert(i);
+    }
+
+    // The nodes are visited in the order of the leaves, so the consecutive
+    // nodes of a job walk through (almost) the same cells.
+    m_order.clear();
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        const Cell& cell = m_cells[stack.back()];
+        stack.pop_back();
+        if (cell.node >= 0) {
+            m_order.emplace_back(cell.node);
+        }
+        for (int q = 3; q >= 0; --q) {
+            if (cell.child[q] >= 0) {
+                stack.emplace_back(cell.child[q]);
+            }
+        }
+    }
+    if (static_cast<int>(m_order.size()) < n) {
+        // the leaves at kMaxDepth hold more than one node
+        std::vector<bool> visited(static_cast<size_t>(n), false);
+        for (int i : m_order) {
+            visited[i] = true;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (!visited[i]) {
+                m_order.emplace_back(i);
+            }
+        }
+    }
+}
+
+int ForceLayout::newChild(int parent, int quadrant)
+{
+    Cell cell = m_cells[parent];
+    cell.half /= 2.f;
+    cell.cx += (quadrant & 1) ? cell.half : -cell.half;
+    cell.cy += (quadrant & 2) ? cell.half : -cell.half;
+    cell.x = cell.y = cell.mass = 0.f;
+    std::fill(cell.child, cell.child + 4, -1);
+    cell.node = -1;
+    m_cells.emplace_back(cell); // might invalidate references to the cells
+    const int idx = static_cast<int>(m_cells.size()) - 1;
+    m_cells[parent].child[quadrant] = idx;
+    return idx;
+}
+
+void ForceLayout::insert(int i)
+{
+    const float x = m_x[i];
+    const float y = m_y[i];
+    int c = 0;
+    for (int depth = 0; ; ++depth) {
+        Cell& cell = m_cells[c];
+        if (cell.mass == 0.f) { // an empty leaf
+            cell.x = x;
+            cell.y = y;
+            cell.mass = 1.f;
+            cell.node = i;
+            return;
+        }
+
+        cell.mass += 1.f;
+        cell.x += (x - cell.x) / cell.mass;
+        cell.y += (y - cell.y) / cell.mass;
+
+        if (depth == kMaxDepth) {
+            cell.node = -1; // it holds more than one node now
+            return;
+        }
+
+        if (cell.node >= 0) {
+            // a leaf with a single node; push it down one level
+            const int other = cell.node;
+            cell.node = -1;
+            const int child = newChild(c, quadrant(m_cells[c], m_x[other], m_y[other]));
+            Cell& otherCell = m_cells[child];
+            otherCell.x = m_x[other];
+            otherCell.y = m_y[other];
+            otherCell.mass = 1.f;
+            otherCell.node = other;
+        }
+
+        const int q = quadrant(m_cells[c], x, y);
+        const int next = m_cells[c].child[q];
+        c = next >= 0 ? next : newChild(c, q);
+    }
+}
+
+inline void ForceLayout::repulsion(int i, float& fx, float& fy) const
+{
+    const float x = m_x[i];
+    const float y = m_y[i];
+    const float theta2 = kTheta * kTheta;
+
+    // depth-first; each level leaves at most 3 cells behind
+    int stack[3 * kMaxDepth + 4];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Cell& cell = m_cells[stack[--top]];
+        if (cell.node == i) {
+            continue;
+        }
+        const float dx = x - cell.x;
+        const float dy = y - cell.y;
+        const float d2 = std::max(dx * dx + dy * dy, kMinDistance2);
+        const bool isLeaf = cell.child[0] < 0 && cell.child[1] < 0
+                && cell.child[2] < 0 && cell.child[3] < 0;
+        if (isLeaf || 4.f * cell.half * cell.half < theta2 * d2) {
+            // k^2/d along (dx,dy)/d, with k = 1
+            const float f = cell.mass / d2;
+            fx += dx * f;
+            fy += dy * f;
+        } else {
+            for (int child : cell.child) {
+                if (child >= 0) {
+                    stack[top++] = child;
+                }
+            }
+        }
+    }
+}
+
+inline void ForceLayout::attraction(int i, float& fx, float& fy) const
+{
+    const float x = m_x[i];
+    const float y = m_y[i];
+    for (int k = m_offsets[i]; k < m_offsets[i + 1]; ++k) {
+        const int j = m_neighbours[k];
+        // d^2/k along (dx,dy)/d, with k = 1
+        const float dx = m_x[j] - x;
+        const float dy = m_y[j] - y;
+        const float d = std::sqrt(dx * dx + dy * dy);
+        fx += dx * d;
+        fy += dy * d;
+    }
+}
+
+void ForceLayout::computeForces(int begin, int end)
+{
+    for (int k = begin; k < end; ++k) {
+        const int i = m_order[k];
+        float fx = 0.f;
+        float fy = 0.f;
+        repulsion(i, fx, fy);
+        attraction(i, fx, fy);
+        // the displacement is limited by the temperature
+        const float f = std::sqrt(fx * fx + fy * fy);
+        const float s = f > 0.f ? std::min(f, m_temperature) / f : 0.f;
+        m_dx[i] = fx * s;
+        m_dy[i] = fy * s;
+    }
+}
+
+} // evoplex
@@ -0,0 +1,118 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FORCELAYOUT_H
+#define FORCELAYOUT_H
+
+#include <vector>
+#include <QtGlobal>
+
+#include "nodes.h"
+
+namespace evoplex {
+
+/**
+ * @brief A force-directed layout of the nodes of a graph.
+ *
+ * It's a Fruchterman-Reingold layout: the edges pull their nodes together
+ * and all nodes push each other apart, while the maximum displacement of a
+ * node (temperature) cools down at every iteration. The repulsion is
+ * approximated with a Barnes-Hut quadtree, i.e., a far away group of nodes
+ * acts as a single node, so that an iteration takes O(n log n) instead of
+ * O(n^2). The forces of each node are computed in parallel.
+ *
+ * The topology is read once in the constructor, thus the layout can run in
+ * a background thread while the graph is shown. The nodes' coordinates are
+ * only written in 'apply()'.
+ */
+class ForceLayout
+{
+public:
+    // Nodes placed at random, the ideal edge length is 1.
+    explicit ForceLayout(const Nodes& nodes, unsigned int seed = 0);
+
+    inline size_t size() const { return m_nodes.size(); }
+    inline int iterations() const { return m_iterations; }
+    inline float temperature() const { return m_temperature; }
+    inline bool isDone() const;
+
+    inline const Node& node(size_t i) const { return m_nodes[i]; }
+    inline float x(size_t i) const { return m_x[i]; }
+    inline float y(size_t i) const { return m_y[i]; }
+
+    // Runs at most 'iterations' iterations.
+    // Returns true if the layout has converged.
+    bool iterate(int iterations = 1);
+
+    // Writes the current positions into the nodes (i.e., setCoords()).
+    void apply() const;
+
+    // Returns true if none of the nodes has coordinates, i.e., they were
+    // created without 'x' and 'y' and no graph has placed them (see
+    // Node::hasCoords()). Note that the default coordinates (0, id) are
+    // also used by some graphs, e.g., a squareGrid with a single column.
+    static bool lacksCoords(const Nodes& nodes);
+
+private:
+    // A square of the quadtree. The leaves hold a single node, except the
+    // ones at kMaxDepth which hold all the nodes at (almost) the same place.
+    struct Cell {
+        float x, y;     // centre of mass
+        float mass;     // number of nodes
+        float cx, cy;   // geometric centre
+        float half;     // half of the side
+        int child[4];   // -1 if none
+        int node;       // the node of a leaf with a single node, -1 otherwise
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_dx;       // displacement of the current iteration
+    std::vector<float> m_dy;
+    std::vector<int> m_offsets;    // neighbours of 'i' are in [m_offsets[i], m_offsets[i+1])
+    std::vector<int> m_neighbours;
+    std::vector<Cell> m_cells;     // m_cells[0] is the root
+    std::vector<int> m_order;      // the nodes sorted by their leaves in the tree
+    std::vector<std::pair<int,int>> m_chunks; // ranges of m_order run in parallel
+
+    int m_iterations;
+    float m_temperature;
+    float m_minTemperature;
+
+    void buildTree();
+    int newChild(int parent, int quadrant);
+    inline int quadrant(const Cell& cell, float x, float y) const;
+    void insert(int i);
+    void computeForces(int begin, int end);
+    inline void repulsion(int i, float& fx, float& fy) const;
+    inline void attraction(int i, float& fx, float& fy) const;
+
+    Q_DISABLE_COPY(ForceLayout)
+};
+
+inline bool ForceLayout::isDone() const
+{ return m_temperature < m_minTemperature; }
+
+inline int ForceLayout::quadrant(const Cell& cell, float x, float y) const
+{ return (x < cell.cx ? 0 : 1) | (y < cell.cy ? 0 : 2); }
+
+} // evoplex
+#endif // FORCELAYOUT_H
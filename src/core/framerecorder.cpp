@@ -0,0 +1,271 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDebug>
+#include <QPainter>
+#include <QtMath>
+#include <cmath>
+#include <limits>
+
+#include "abstractgraph.h"
+#include "forcelayout.h"
+#include "framerecorder.h"
+#include "trial.h"
+
+namespace evoplex {
+
+namespace {
+const int kMaxLayoutIterations = 500;
+}
+
+FrameRecorder::FrameRecorder(const Trial* trial, AttributeRangePtr attrRange,
+                             int stepInterval, const QString& filePrefix,
+                             QObject* parent)
+    : QThread(parent),
+      m_trial(trial),
+      m_attrRange(attrRange),
+      m_stepInterval(qMax(1, stepInterval)),
+      m_filePrefix(filePrefix),
+      m_layout(Layout::Grid),
+      m_cellLength(1),
+      m_imageSize(800, 800),
+      m_nodeRadius(3.),
+      m_format("png"),
+      m_lastStep(-1),
+      m_stop(false),
+      m_framesSaved(0),
+      m_framesSkipped(0)
+{
+    Q_ASSERT_X(m_attrRange, "FrameRecorder", "it needs a node attribute");
+    const ColorMapMgr cMgr;
+    setColors(cMgr.colors(cMgr.defaultCMapKey()));
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    stop();
+    wait();
+}
+
+void FrameRecorder::stop()
+{
+    m_stop = true;
+}
+
+void FrameRecorder::setColors(const Colors& colors)
+{
+    if (!colors.empty()) {
+        m_cmap.reset(ColorMap::create(m_attrRange, colors));
+    }
+}
+
+QRgb FrameRecorder::rgb(const Value& value) const
+{
+    if (!value.isValid()) {
+        return 0;
+    }
+    try {
+        return m_cmap->rgb(value);
+    } catch (std::out_of_range) {
+        return 0;
+    }
+}
+
+bool FrameRecorder::init(QString& error)
+{
+    const AbstractGraph* graph = m_trial ? m_trial->graph() : nullptr;
+    if (!graph || graph->nodes().empty()) {
+        error += "unable to record: the trial has no nodes";
+        return false;
+    }
+    if (m_trial->status() == Status::Running) {
+        error += "unable to record: the trial is running";
+        return false;
+    }
+
+    setGeometry(graph->nodes(), graph->edges());
+
+    // the trial publishes every 'm_stepInterval' steps from now on
+    m_snapshot = m_trial->subscribeNodes(m_attrRange->id(), m_stepInterval);
+    return true;
+}
+
+void FrameRecorder::setGeometry(const Nodes& nodes, const Edges& edges)
+{
+    m_points.clear();
+    m_edges.clear();
+    m_points.reserve(nodes.size());
+
+    // the nodes of a graph without coordinates are laid out here, so that
+    // it works without the GUI; the nodes themselves are left untouched
+    std::unordered_map<int, QPointF> layout;
+    if (m_layout == Layout::Graph && ForceLayout::lacksCoords(nodes)) {
+        ForceLayout fl(nodes);
+        fl.iterate(kMaxLayoutIterations);
+        layout.reserve(fl.size());
+        for (size_t i = 0; i < fl.size(); ++i) {
+            layout.insert({fl.node(i).id(), QPointF(fl.x(i), fl.y(i))});
+        }
+    }
+    auto xy = [&layout](const Node& node) {
+        return layout.empty() ? QPointF(node.x(), node.y()) : layout.at(node.id());
+    };
+
+    qreal left = std::numeric_limits<qreal>::max();
+    qreal top = left;
+    qreal right = std::numeric_limits<qreal>::lowest();
+    qreal bottom = right;
+    for (auto const& np : nodes) {
+        const QPointF p = xy(np.second);
+        m_points.push_back({static_cast<size_t>(np.first), p});
+        left = qMin(left, p.x());
+        top = qMin(top, p.y());
+        right = qMax(right, p.x());
+        bottom = qMax(bottom, p.y());
+    }
+    m_bounds = m_points.empty() ? QRectF()
+                                : QRectF(QPointF(left, top), QPointF(right, bottom));
+
+    if (m_layout == Layout::Graph) {
+        // the implicit topologies have no edges stored; they're not drawn
+        m_edges.reserve(edges.size());
+        for (auto const& ep : edges) {
+            m_edges.emplace_back(xy(ep.second.origin()), xy(ep.second.neighbour()));
+        }
+    }
+}
+
+QImage FrameRecorder::render(const Values& values)
+{
+    m_cmap->rgb(values, m_rgbs);
+    return m_layout == Layout::Grid ? renderGrid() : renderGraph();
+}
+
+void FrameRecorder::run()
+{
+    if (!m_snapshot) {
+        qWarning() << "the recorder must be initialized first";
+        return;
+    }
+
+    bool stopping = false;
+    while (!stopping) {
+        // reads 'm_stop' first, so the last frame is never missed
+        stopping = m_stop;
+        while (m_snapshot->acquire()) {
+            saveFrame(m_snapshot->front());
+        }
+        if (!stopping) {
+            msleep(NodesSnapshot::PublishInterval);
+        }
+    }
+    m_snapshot.reset(); // the trial stops publishing
+}
+
+void FrameRecorder::saveFrame(const NodesSnapshot::Frame& frame)
+{
+    if (m_lastStep >= 0 && frame.step > m_lastStep + m_stepInterval) {
+        m_framesSkipped += (frame.step - m_lastStep) / m_stepInterval - 1;
+    }
+    m_lastStep = frame.step;
+
+    const QImage img = render(frame.values);
+
+    const QString filePath = QString("%1_%2.%3").arg(m_filePrefix)
+            .arg(frame.step, 8, 10, QChar('0')).arg(m_format);
+    if (!img.save(filePath, qPrintable(m_format))) {
+        qWarning() << "unable to save the frame" << filePath;
+        emit (failed("unable to save " + filePath));
+        return;
+    }
+    ++m_framesSaved;
+    emit (frameSaved(frame.step, filePath));
+}
+
+QImage FrameRecorder::renderGrid() const
+{
+    // one pixel per cell, then scaled up at once
+    const int cols = qFloor(m_bounds.width()) + 1;
+    const int rows = qFloor(m_bounds.height()) + 1;
+    QImage img(cols, rows, QImage::Format_ARGB32);
+    img.fill(Qt::transparent);
+
+    // ARGB32 rows are never padded, so the cells are just an array of pixels
+    QRgb* pixels = reinterpret_cast<QRgb*>(img.bits());
+    for (const Point& p : m_points) {
+        if (p.id < m_rgbs.size()) {
+            const int col = qFloor(p.xy.x() - m_bounds.left());
+            const int row = qFloor(p.xy.y() - m_bounds.top());
+            pixels[row * cols + col] = m_rgbs[p.id];
+        }
+    }
+
+    if (m_cellLength == 1) {
+        return img;
+    }
+    return img.scaled(cols * m_cellLength, rows * m_cellLength,
+                      Qt::IgnoreAspectRatio, Qt::FastTransformation);
+}
+
+QImage FrameRecorder::renderGraph() const
+{
+    QImage img(m_imageSize, QImage::Format_ARGB32);
+    img.fill(Qt::white);
+
+    // fits the bounds of the nodes into the image
+    const qreal margin = m_nodeRadius + 1.;
+    const qreal sx = (m_imageSize.width() - 2. * margin) / qMax(m_bounds.width(), 1.);
+    const qreal sy = (m_imageSize.height() - 2. * margin) / qMax(m_bounds.height(), 1.);
+    const qreal scale = qMin(sx, sy);
+    auto map = [this, margin, scale](const QPointF& xy) {
+        return (xy - m_bounds.topLeft()) * scale + QPointF(margin, margin);
+    };
+
+    QPainter painter(&img);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    if (!m_edges.empty()) {
+        QVector<QLineF> lines;
+        lines.reserve(static_cast<int>(m_edges.size()));
+        for (const QLineF& l : m_edges) {
+            lines.push_back(QLineF(map(l.p1()), map(l.p2())));
+        }
+        painter.setPen(QPen(QColor(200, 200, 200), 1));
+        painter.drawLines(lines);
+    }
+
+    painter.setPen(Qt::NoPen);
+    QRgb brushRgb = 0;
+    painter.setBrush(QColor::fromRgba(brushRgb));
+    for (const Point& p : m_points) {
+        if (p.id >= m_rgbs.size()) {
+            continue;
+        }
+        if (m_rgbs[p.id] != brushRgb) { // neighbours tend to share the colour
+            brushRgb = m_rgbs[p.id];
+            painter.setBrush(QColor::fromRgba(brushRgb));
+        }
+        painter.drawEllipse(map(p.xy), m_nodeRadius, m_nodeRadius);
+    }
+    painter.end();
+    return img;
+}
+
+} // evoplex
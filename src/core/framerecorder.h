@@ -0,0 +1,150 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAMERECORDER_H
+#define FRAMERECORDER_H
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <QImage>
+#include <QLineF>
+#include <QRectF>
+#include <QSize>
+#include <QThread>
+
+#include "attributerange.h"
+#include "colormap.h"
+#include "edges.h"
+#include "nodes.h"
+#include "snapshot.h"
+
+namespace evoplex {
+
+class Trial;
+
+/**
+ * @brief Records the nodes of a trial into a sequence of images, offscreen.
+ *
+ * The trial publishes a snapshot of the recorded node attribute every
+ * 'stepInterval' steps, which is rendered and saved in the recorder's own
+ * thread. So, it does not need the GUI (e.g., it works in a QCoreApplication)
+ * and never makes the trial wait: if the recorder falls behind, the frames
+ * in between are skipped (see framesSkipped()).
+ *
+ * The nodes' coordinates (and edges) are read once, in 'init()', i.e., the
+ * trial must not be running at that point. The frames are saved
+ * in 'filePrefix'_<step>.<format>, e.g., "/tmp/exp1_trial0_00000100.png".
+ *
+ * @see OUTPUT_FRAMES
+ */
+class FrameRecorder : public QThread
+{
+    Q_OBJECT
+
+public:
+    enum class Layout {
+        Grid,  // one cell per node, 'cellLength' pixels wide
+        Graph  // nodes and edges fitted to 'imageSize'
+    };
+
+    // 'attrRange' is the node attribute to be recorded
+    explicit FrameRecorder(const Trial* trial, AttributeRangePtr attrRange,
+                           int stepInterval, const QString& filePrefix,
+                           QObject* parent = nullptr);
+    ~FrameRecorder() override;
+
+    // These settings must be set before 'init()'.
+    inline void setLayout(Layout layout) { m_layout = layout; }
+    inline void setCellLength(int length) { m_cellLength = qMax(1, length); }
+    inline void setImageSize(const QSize& size) { m_imageSize = size; }
+    inline void setNodeRadius(qreal radius) { m_nodeRadius = radius; }
+    inline void setFormat(const QString& format) { m_format = format; }
+
+    // Sets the colours of the values of the attribute, which are mapped as
+    // in the GUI (see ColorMap::create()). By default, it uses the user's
+    // default colour map (see ColorMapMgr).
+    void setColors(const Colors& colors);
+
+    // Reads the nodes' coordinates and subscribes the snapshot.
+    // It must be called while the trial is not running, before 'start()'.
+    bool init(QString& error);
+
+    // Reads the nodes' coordinates (and the edges, for Layout::Graph). If
+    // none of the nodes has coordinates, they are placed by a ForceLayout.
+    void setGeometry(const Nodes& nodes, const Edges& edges);
+
+    // Renders the values (indexed by node id) with the current geometry.
+    QImage render(const Values& values);
+
+    // Returns the colour of a value of the attribute; transparent if it has none.
+    QRgb rgb(const Value& value) const;
+
+    // Saves the frame published last (if any) and finishes the thread.
+    void stop();
+
+    inline int framesSaved() const { return m_framesSaved; }
+    inline int framesSkipped() const { return m_framesSkipped; }
+
+signals:
+    void frameSaved(int step, const QString& filePath);
+    void failed(const QString& error);
+
+protected:
+    void run() override;
+
+private:
+    struct Point {
+        size_t id;
+        QPointF xy;
+    };
+
+    const Trial* m_trial;
+    const AttributeRangePtr m_attrRange;
+    const int m_stepInterval;
+    const QString m_filePrefix;
+
+    Layout m_layout;
+    int m_cellLength;
+    QSize m_imageSize;
+    qreal m_nodeRadius;
+    QString m_format;
+
+    std::unique_ptr<ColorMap> m_cmap;
+
+    NodesSnapshotPtr m_snapshot;
+    std::vector<Point> m_points;  // the nodes' coordinates
+    std::vector<QLineF> m_edges;  // in the nodes' coordinates
+    QRectF m_bounds;
+    std::vector<QRgb> m_rgbs;     // the colours of the current frame
+    int m_lastStep;
+
+    std::atomic<bool> m_stop;
+    std::atomic<int> m_framesSaved;
+    std::atomic<int> m_framesSkipped;
+
+    void saveFrame(const NodesSnapshot::Frame& frame);
+    QImage renderGrid() const;
+    QImage renderGraph() const;
+};
+
+} // evoplex
+#endif // FRAMERECORDER_H
@@ -26,8 +26,8 @@
 
 namespace evoplex {
 
-GraphPlugin::GraphPlugin(QPluginLoader* loader, const QString& libPath)
-    : Plugin(PluginType::Graph, loader, libPath),
+GraphPlugin::GraphPlugin(const QJsonObject& metaData, const QString& libPath)
+    : Plugin(PluginType::Graph, metaData, libPath),
       m_supportsEdgeAttrsGen(false)
 {
     if (m_type == PluginType::Invalid) {
@@ -41,7 +41,7 @@ public:
     inline bool supportsEdgeAttrsGen() const;
 
 protected:
-    explicit GraphPlugin(QPluginLoader* loader, const QString& libPath);
+    explicit GraphPlugin(const QJsonObject& metaData, const QString& libPath);
 
 private:
     bool m_supportsEdgeAttrsGen;
@@ -21,6 +21,8 @@
 #ifndef ABSTRACT_GRAPH_H
 #define ABSTRACT_GRAPH_H
 
+#include <atomic>
+#include <vector>
 #include <QtDebug>
 #include <QMutex>
 
@@ -65,6 +67,12 @@ public:
     inline int numNodes() const;
     inline int numEdges() const;
 
+    // They change whenever a node (or an edge) is added or removed, so that
+    // the containers built from the graph know when to rebuild it. They can
+    // be read from other threads (e.g., the GUI) while the trial runs.
+    inline quint64 nodesVersion() const;
+    inline quint64 edgesVersion() const;
+
     inline Node addNode(Attributes attr);
     Node addNode(Attributes attr, int x, int y);
 
@@ -81,6 +89,30 @@ public:
     void removeEdge(const Edge& edge);
     Edges::iterator removeEdge(Edges::iterator it);
 
+    // Implicit topology (optional)
+    // Graphs in which the neighbours are a pure function of the node id
+    // (eg, lattices) may compute them on the fly instead of storing the edges.
+    // Such graphs reimplement 'supportsImplicitEdges()' and 'neighbourIds()'.
+    // Models which do not use the Edge objects can call 'setEdgesRequired(false)'
+    // in their 'init()'; then, the edges are only created if the experiment
+    // has edge attributes. Thus, 'outEdges()' might be empty, but
+    // 'neighbourIds()' is always valid.
+    virtual bool supportsImplicitEdges() const;
+    inline bool hasImplicitEdges() const;
+    inline bool edgesRequired() const;
+    inline void setEdgesRequired(bool required);
+
+    // Fills 'ids' with the ids of the out-neighbours of the node.
+    // The default implementation reads the node's out-edges.
+    virtual void neighbourIds(const int nodeId, std::vector<int>& ids) const;
+
+    // When an experiment is reset, its trials keep their graphs and only the
+    // nodes' attributes are restored. Graphs whose 'reset()' creates the very
+    // same edges every time (ie, it does not use the PRG) should reimplement
+    // it to return false, so that the edges are kept as well.
+    // The default implementation returns true.
+    virtual bool hasRandomTopology() const;
+
 protected:
     AttrsGeneratorPtr m_edgeAttrsGen;
     Edges m_edges;
@@ -95,9 +127,17 @@ protected:
 private:
     int m_lastNodeId;
     int m_lastEdgeId;
+    bool m_edgesRequired;
+    bool m_topologyChanged; // nodes or edges were added/removed after reset()
+    std::atomic<quint64> m_nodesVersion; // see nodesVersion()
+    std::atomic<quint64> m_edgesVersion;
     QMutex m_mutex;
 
     std::uniform_int_distribution<int> m_numNodesDist;
+
+    // removes all edges and releases their containers, so that the
+    // edges can be created again as in a new graph (eg, same ids)
+    void resetEdges();
 };
 
 
@@ -129,11 +169,26 @@ inline int AbstractGraph::numEdges() const
 inline int AbstractGraph::numNodes() const
 { return static_cast<int>(m_nodes.size()); }
 
+inline quint64 AbstractGraph::nodesVersion() const
+{ return m_nodesVersion.load(std::memory_order_relaxed); }
+
+inline quint64 AbstractGraph::edgesVersion() const
+{ return m_edgesVersion.load(std::memory_order_relaxed); }
+
 inline Node AbstractGraph::addNode(Attributes attr)
 { return addNode(attr, 0, m_lastNodeId+1); }
 
 inline Edge AbstractGraph::addEdge(const int originId, const int neighbourId, Attributes* attrs)
 {  return addEdge(m_nodes.at(originId), m_nodes.at(neighbourId), attrs); }
 
+inline bool AbstractGraph::hasImplicitEdges() const
+{ return !m_edgesRequired && !m_edgeAttrsGen && supportsImplicitEdges(); }
+
+inline bool AbstractGraph::edgesRequired() const
+{ return m_edgesRequired; }
+
+inline void AbstractGraph::setEdgesRequired(bool required)
+{ m_edgesRequired = required; }
+
 } // evoplex
 #endif // ABSTRACT_GRAPH_H
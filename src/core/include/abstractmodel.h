@@ -21,11 +21,16 @@
 #ifndef ABSTRACT_MODEL_H
 #define ABSTRACT_MODEL_H
 
+#include <limits>
 #include <memory.h>
+#include <memory>
 #include <vector>
 
 #include "abstractplugin.h"
 #include "abstractgraph.h"
+#include "activeset.h"
+#include "nodeattr.h"
+#include "nodesequence.h"
 #include "edges.h"
 #include "nodes.h"
 
@@ -77,6 +82,35 @@ public:
     inline const Edge& edge(int edgeId) const;
     inline const Edge& edge(int originId, int neighbourId) const;
 
+    // Active-set scheduling (optional; see ActiveSet)
+    // Call 'enableActiveSet()' in 'init()'. Then, in each step, visit only
+    // the 'activeNodes()' and mark the nodes which changed with 'markDirty()'.
+    // Nodes which did not change but must be visited again in the next
+    // step can be scheduled with 'keepActive()'.
+    void enableActiveSet();
+    inline bool hasActiveSet() const;
+    inline const std::vector<Node>& activeNodes() const;
+    inline bool isActive(const Node& node) const;
+    inline void markDirty(const Node& node);
+    inline void keepActive(const Node& node);
+
+    // Asynchronous (random-sequential) updates
+    // 'randomOrder()' visits all nodes once in a new random order, and
+    // 'randomDraws()' draws 'n' nodes at random with replacement (n<0 for
+    // as many draws as nodes). eg, for (const Node& node : randomOrder()) {}
+    // The sequences are lazy, i.e., no memory is allocated in each step.
+    NodeSequence randomOrder();
+    NodeSequence randomDraws(int n=-1);
+
+    // Typed access to the node's attributes (see NodeAttr)
+    // Call it in 'init()', eg, 'm_live = nodeAttr<bool>("live");'. The type
+    // is checked once against the model's nodeAttributesScope, so reading
+    // and writing through the view does not check it again.
+    // It returns an invalid view if the attribute does not exist or if T
+    // does not match its type.
+    template<typename T>
+    NodeAttr<T> nodeAttr(const QString& name) const;
+
     // AbstractModelInterface stuff
     // the default implementation of the methods below do nothing
     inline void beforeLoop() override {}
@@ -87,6 +121,18 @@ public:
 protected:
     AbstractModel() = default;
     ~AbstractModel() override = default;
+
+private:
+    std::unique_ptr<ActiveSet> m_activeSet;
+    std::vector<Node> m_nodesIndex; // random access to the nodes
+    quint64 m_nodesIndexVersion = 0; // the graph's nodesVersion() of 'm_nodesIndex'
+
+    const std::vector<Node>* nodesIndex();
+
+    // the id of the node's attribute 'name' if its values are held by 'type'
+    // and its range is within [lowest, highest]; -1 otherwise
+    int nodeAttrId(const QString& name, Value::Type type,
+                   double lowest, double highest) const;
 };
 
 /************************************************************************
@@ -108,5 +154,28 @@ inline const Edge& AbstractModel::edge(int edgeId) const
 inline const Edge &AbstractModel::edge(int originId, int neighbourId) const
 { return node(originId).outEdges().at(neighbourId); }
 
+inline bool AbstractModel::hasActiveSet() const
+{ return m_activeSet != nullptr; }
+
+inline const std::vector<Node>& AbstractModel::activeNodes() const
+{ Q_ASSERT(m_activeSet); return m_activeSet->nodes(); }
+
+inline bool AbstractModel::isActive(const Node& node) const
+{ Q_ASSERT(m_activeSet); return m_activeSet->isActive(node.id()); }
+
+inline void AbstractModel::markDirty(const Node& node)
+{ Q_ASSERT(m_activeSet); m_activeSet->markDirty(node); }
+
+inline void AbstractModel::keepActive(const Node& node)
+{ Q_ASSERT(m_activeSet); m_activeSet->keepActive(node); }
+
+template<typename T>
+inline NodeAttr<T> AbstractModel::nodeAttr(const QString& name) const
+{
+    return NodeAttr<T>(nodeAttrId(name, AttrType<T>::type,
+                                  static_cast<double>(std::numeric_limits<T>::lowest()),
+                                  static_cast<double>(std::numeric_limits<T>::max())));
+}
+
 } // evoplex
 #endif // ABSTRACT_MODEL_H
@@ -0,0 +1,102 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ACTIVESET_H
+#define ACTIVESET_H
+
+#include <vector>
+#include <QtGlobal>
+
+#include "node.h"
+#include "nodes.h"
+
+namespace evoplex {
+
+/**
+ * @brief Worklist of the nodes which need to be visited in a step.
+ *
+ * In many models, a node can only change its state if itself or one of its
+ * neighbours changed in the previous step. The model marks the nodes which
+ * changed (markDirty) and, in the next step, visits only the active nodes,
+ * i.e., the dirty nodes and all the nodes which have them as neighbours.
+ * A node can also be kept active without affecting its neighbours (keepActive).
+ *
+ * The membership is tracked by dense bitsets indexed by the node id, so that
+ * the cost of each step depends on the number of active nodes, not on the
+ * size of the graph. In the first step, all nodes are active.
+ */
+class ActiveSet
+{
+public:
+    ActiveSet();
+
+    // the node and its in-neighbours will be active in the next step
+    void markDirty(const Node& node);
+
+    // the node will be active in the next step
+    void keepActive(const Node& node);
+
+    // all nodes will be active in the next step
+    inline void activateAll() { m_all = true; }
+
+    // Builds the worklist of the next step and clears the marked nodes.
+    // It's called by the Trial right before each step.
+    void advance(const Nodes& nodes);
+
+    inline const std::vector<Node>& nodes() const { return m_active; }
+    // the nodes marked dirty since the last 'advance()'
+    inline const std::vector<Node>& dirtyNodes() const { return m_dirty; }
+    inline bool isActive(const int nodeId) const { return testBit(m_activeBits, nodeId); }
+
+private:
+    bool m_all;
+    std::vector<Node> m_active;  // worklist of the current step
+    std::vector<Node> m_dirty;   // nodes marked dirty in the current step
+    std::vector<Node> m_kept;    // nodes kept active in the current step
+    std::vector<quint64> m_activeBits;
+    std::vector<quint64> m_dirtyBits;
+
+    void activate(const Node& node);
+
+    static inline bool testBit(const std::vector<quint64>& bits, const int i)
+    {
+        const size_t w = static_cast<size_t>(i) >> 6;
+        return w < bits.size() && (bits[w] >> (i & 63)) & 1ULL;
+    }
+
+    // sets the bit 'i' and returns its previous value
+    static inline bool testAndSetBit(std::vector<quint64>& bits, const int i)
+    {
+        const size_t w = static_cast<size_t>(i) >> 6;
+        if (w >= bits.size()) {
+            bits.resize(w + 1, 0);
+        }
+        const quint64 mask = 1ULL << (i & 63);
+        const bool wasSet = bits[w] & mask;
+        bits[w] |= mask;
+        return wasSet;
+    }
+
+    static inline void clearBit(std::vector<quint64>& bits, const int i)
+    { bits[static_cast<size_t>(i) >> 6] &= ~(1ULL << (i & 63)); }
+};
+
+} // evoplex
+#endif // ACTIVESET_H
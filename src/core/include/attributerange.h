@@ -85,6 +85,11 @@ public:
     //   - "int{1,2,3}"         // set of integers
     //   - "double[min,max]     // doubles from min to max (including min and max)
     //   - "double{1.1,1.2}     // set of doubles
+    //   - "float[min,max]"     // doubles rounded to single precision (also "float{ }")
+    //   - "int8[min,max]"      // integers within the limits of 8 bits (also "uint8",
+    //                          // "int16" and "uint16"; and sets, e.g., "int8{0,1,2,3}")
+    //   * the narrow types only restrict the values, which are still held by
+    //     a Value (ie, int or double) like any other
     //   * you can use 'max' to take the maximum value for the type
     //   * do NOT add spaces before/after the commas
     static AttributeRangePtr parse(int attrId, const QString& attrName,
@@ -108,18 +113,24 @@ protected:
     const int m_id;
     const QString m_attrName;
     const Type m_type;
+    const QString m_typeStr;
     QString m_attrRangeStr;
     Value m_min;
     Value m_max;
 
-    explicit AttributeRange(int id, const QString& attrName, Type type);
+    // 'typeStr' is the prefix of the attrRangeStr, e.g., 'int', 'uint8' or
+    // 'float'; if empty, it's the one implied by the type
+    explicit AttributeRange(int id, const QString& attrName, Type type,
+                            const QString& typeStr=QString());
+
+    inline const QString& typeStr() const { return m_typeStr; }
 
 private:
-    // assume that attrRangeStr is equal to 'int{ }' or 'double{ }'
+    // assume that attrRangeStr is equal to 'int{ }', 'double{ }', 'float{ }', 'int8{ }' etc
     static AttributeRangePtr setOfValues(QString attrRangeStr, const int id,
                                          const QString& attrName);
 
-    // assume that attrRangeStr is equal to 'int[min,max]' or 'double[min,max]'
+    // assume that attrRangeStr is equal to 'int[min,max]', 'double[min,max]', 'float[min,max]' etc
     static AttributeRangePtr intervalOfValues(QString attrRangeStr, const int id,
                                               const QString& attrName);
 };
@@ -141,7 +152,7 @@ class IntervalOfValues : public AttributeRange
 {
 public:
     IntervalOfValues(int id, const QString& attrName, Type type,
-                     const Value &min, const Value &max);
+                     const Value &min, const Value &max, const QString& typeStr=QString());
 
     ~IntervalOfValues() override = default;
 
@@ -158,7 +169,8 @@ private:
 class SetOfValues : public AttributeRange
 {
 public:
-    SetOfValues(int id, const QString& attrName, Type type, Values values);
+    SetOfValues(int id, const QString& attrName, Type type, Values values,
+                const QString& typeStr=QString());
 
     ~SetOfValues() override = default;
 
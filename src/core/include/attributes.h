@@ -41,6 +41,9 @@ typedef std::vector<Attributes> SetOfAttributes;
  */
 class Attributes
 {
+    friend class BaseNode;
+    friend class Node;
+
 public:
     Attributes() {}
     Attributes(int size) { resize(size); }
@@ -44,11 +44,17 @@
 #define GENERAL_ATTR_AUTODELETE "autoDelete"       // automatically deletes the experiment from memory
 #define GENERAL_ATTR_GRAPHTYPE "graphType"         // graph type of a graph generator
 #define GENERAL_ATTR_EDGEATTRS "edgeAttrs"         // a command to AttrsGenerator
+#define GENERAL_ATTR_STEADYSTATE "steadyState"     // n>0 (up to 1000) to finish a trial when it reaches a cycle of length <=n (1 for fixed points); 0 to disable; ignored if the model uses the PRG
+#define GENERAL_ATTR_STEADYPAD "steadyStatePad"    // 1 to keep saving the outputs (the values of the cycle) until stopAt once a steady state is reached; 0 otherwise
 
 #define OUTPUT_DIR "outputDirectory"              // path to the directory in which the file will be saved
-#define OUTPUT_AVGTRIALS "outputAvgTrials"        // 1 to indicate if the output should be done across all trials; 0 otherwise
+#define OUTPUT_AVGTRIALS "outputAvgTrials"        // 1 to indicate if the output should be done across all trials; 0 otherwise. With more trials than threads, the summary of each saved step is held in memory until all trials reach it
 #define OUTPUT_HEADER "outputHeader"              // valid header
 #define OUTPUT_SAVESTEPS "outputSaveSteps"        // n=0 to save all steps; n>0 to save the last n steps
+#define OUTPUT_STARTAT "outputStartAt"            // first step in which the outputs are evaluated
+#define OUTPUT_INTERVAL "outputInterval"          // n>0 to evaluate the outputs every n steps
+#define OUTPUT_FRAMES "outputFrames"              // node attribute saved as images in the output directory; empty to disable
+#define OUTPUT_FRAMESINTERVAL "outputFramesInterval" // n>0 to save an image every n steps
 
 /******************************************************************************
     Plugin stuff
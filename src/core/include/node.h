@@ -32,11 +32,15 @@ namespace evoplex {
 class BaseNode;
 using NodePtr = std::shared_ptr<BaseNode>;
 
+template<typename T> class NodeAttr;
+
 class Node
 {
     friend class AbstractGraph;
     friend class NodesPrivate;
     friend class TestNodes;
+    friend class TestForceLayout;
+    template<typename T> friend class NodeAttr;
 
 public:
     Node();
@@ -54,8 +58,10 @@ public:
     int id() const;
     float x() const;
     float y() const;
+    // false if the node was created without coordinates (see BaseNode)
+    bool hasCoords() const;
 
-    const Attributes& attrs() const;
+    inline const Attributes& attrs() const;
     const Value& attr(int id) const;
     Value attr(const QString& name, Value defaultValue=Value()) const;
 
@@ -74,7 +80,22 @@ public:
 
 private:
     NodePtr m_ptr;
+    // the attributes of *m_ptr, so that they're read/written inline (see NodeAttr)
+    Attributes* m_attrs;
+
+    // unchecked write access to the attribute 'id' (see NodeAttr)
+    inline Value& attrRef(int id) const;
 };
 
+/************************************************************************
+   Node: Inline member functions
+ ************************************************************************/
+
+inline const Attributes& Node::attrs() const
+{ return *m_attrs; }
+
+inline Value& Node::attrRef(int id) const
+{ return m_attrs->m_values[static_cast<size_t>(id)]; }
+
 } // evoplex
 #endif // NODE_P_H
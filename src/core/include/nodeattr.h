@@ -0,0 +1,108 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NODEATTR_H
+#define NODEATTR_H
+
+#include "attributerange.h"
+#include "node.h"
+#include "value.h"
+
+namespace evoplex {
+
+// maps a C++ type to the Value::Type which holds it
+template<typename T> struct AttrType;
+#define EVOPLEX_ATTR_TYPE(T, VALUE_TYPE) \
+template<> struct AttrType<T> { static const Value::Type type = Value::VALUE_TYPE; };
+EVOPLEX_ATTR_TYPE(bool, BOOL)
+EVOPLEX_ATTR_TYPE(char, CHAR)
+EVOPLEX_ATTR_TYPE(qint8, INT)
+EVOPLEX_ATTR_TYPE(quint8, INT)
+EVOPLEX_ATTR_TYPE(qint16, INT)
+EVOPLEX_ATTR_TYPE(quint16, INT)
+EVOPLEX_ATTR_TYPE(int, INT)
+EVOPLEX_ATTR_TYPE(float, DOUBLE)
+EVOPLEX_ATTR_TYPE(double, DOUBLE)
+#undef EVOPLEX_ATTR_TYPE
+
+/**
+ * @brief A typed view of a node's attribute.
+ *
+ * The Value getters (e.g., Value::toBool()) check the type of the Value in
+ * every call. In the inner loop of a model, this check is paid for each node
+ * and neighbour in each step, even though the types of the node's attributes
+ * never change during a trial.
+ *
+ * A NodeAttr is obtained from AbstractModel::nodeAttr() in the model's init(),
+ * which checks once that the attribute exists and that its type in the
+ * model's nodeAttributesScope matches T. Then, get() and set() are a plain
+ * load/store in the Value's data. T is either the type of the Value (bool,
+ * int or double) or a narrower one which holds all the values of the
+ * attribute's range (e.g., qint8 for 'int8{0,1,2,3}' or float for
+ * 'float[0,1]'); the values are still held by the Value, i.e., it's just a
+ * conversion. An invalid view (isValid() == false) must not be used, i.e.,
+ * init() should return false.
+ *
+ * @code
+ *   NodeAttr<bool> m_live;
+ *   // init()
+ *   m_live = nodeAttr<bool>("live");
+ *   return m_live.isValid();
+ *   // algorithmStep()
+ *   if (m_live(node)) { m_live.set(node, false); }
+ * @endcode
+ */
+template<typename T>
+class NodeAttr
+{
+    friend class AbstractModel;
+
+public:
+    NodeAttr() : m_id(-1) {}
+
+    inline bool isValid() const { return m_id >= 0; }
+    inline int id() const { return m_id; }
+
+    inline T get(const Node& node) const;
+    inline T operator()(const Node& node) const { return get(node); }
+    inline void set(const Node& node, T value) const;
+
+private:
+    int m_id;
+
+    explicit NodeAttr(int id) : m_id(id) {}
+};
+
+template<typename T>
+inline T NodeAttr<T>::get(const Node& node) const
+{
+    Q_ASSERT(isValid() && node.attr(m_id).type() == AttrType<T>::type);
+    return node.attrs().values()[static_cast<size_t>(m_id)].get<T>();
+}
+
+template<typename T>
+inline void NodeAttr<T>::set(const Node& node, T value) const
+{
+    Q_ASSERT(isValid() && node.attr(m_id).type() == AttrType<T>::type);
+    node.attrRef(m_id).set<T>(value);
+}
+
+} // evoplex
+#endif // NODEATTR_H
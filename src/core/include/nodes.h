@@ -42,6 +42,7 @@ public:
     using std::unordered_map<int, Node>::iterator;
     using std::unordered_map<int, Node>::const_iterator;
     using std::unordered_map<int, Node>::empty;
+    using std::unordered_map<int, Node>::find;
     using std::unordered_map<int, Node>::size;
 };
 
@@ -0,0 +1,122 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NODESEQUENCE_H
+#define NODESEQUENCE_H
+
+#include <iterator>
+#include <vector>
+#include <QtGlobal>
+
+#include "node.h"
+#include "prg.h"
+
+namespace evoplex {
+
+/**
+ * @brief A pseudo-random permutation of [0, n) evaluated lazily.
+ *
+ * It's a bijection built with a 4-round Feistel network over the smallest
+ * power of four greater than or equal to n, keyed by the PRG. Values out of
+ * range are mapped back into [0, n) by cycle-walking, i.e., encrypting them
+ * again. Thus, the i-th element is computed in (expected) constant time and
+ * without storing the permutation.
+ */
+class RandomPermutation
+{
+public:
+    RandomPermutation(quint64 n, PRG* prg);
+
+    inline quint64 size() const { return m_n; }
+
+    // the i-th element of the permutation; i must be in [0, n)
+    quint64 at(quint64 i) const;
+
+private:
+    quint64 m_n;
+    int m_halfBits;
+    quint64 m_halfMask;
+    quint64 m_keys[4];
+
+    quint64 encrypt(quint64 x) const;
+};
+
+/**
+ * @brief A lazy sequence of nodes, used to perform asynchronous updates.
+ * @see AbstractModel::randomOrder() and AbstractModel::randomDraws()
+ *
+ * It does not allocate memory: the nodes are picked from an index owned by
+ * the model either following a RandomPermutation (each node is visited once)
+ * or drawn uniformly at random with replacement.
+ */
+class NodeSequence
+{
+public:
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Node;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Node*;
+        using reference = const Node&;
+
+        const_iterator(const NodeSequence* seq, quint64 i)
+            : m_seq(seq), m_i(i), m_idx(0) { if (i < seq->m_size) m_idx = seq->index(i); }
+
+        inline const Node& operator*() const { return (*m_seq->m_nodes)[m_idx]; }
+        inline const Node* operator->() const { return &(*m_seq->m_nodes)[m_idx]; }
+        inline const_iterator& operator++()
+        { if (++m_i < m_seq->m_size) m_idx = m_seq->index(m_i); return *this; }
+        inline bool operator==(const const_iterator& o) const { return m_i == o.m_i; }
+        inline bool operator!=(const const_iterator& o) const { return m_i != o.m_i; }
+
+    private:
+        const NodeSequence* m_seq;
+        quint64 m_i;
+        size_t m_idx;
+    };
+
+    // each node is visited once in a random order
+    NodeSequence(const std::vector<Node>* nodes, PRG* prg);
+
+    // 'n' nodes drawn uniformly at random with replacement
+    NodeSequence(const std::vector<Node>* nodes, PRG* prg, quint64 n);
+
+    inline const_iterator begin() const { return const_iterator(this, 0); }
+    inline const_iterator end() const { return const_iterator(this, m_size); }
+    inline quint64 size() const { return m_size; }
+
+private:
+    const std::vector<Node>* m_nodes;
+    PRG* m_prg;
+    const bool m_replacement;
+    const quint64 m_size;
+    RandomPermutation m_perm;
+
+    inline size_t index(quint64 i) const
+    {
+        return static_cast<size_t>(m_replacement
+                ? m_prg->uniform(size_t(0), m_nodes->size() - 1) : m_perm.at(i));
+    }
+};
+
+} // evoplex
+#endif // NODESEQUENCE_H
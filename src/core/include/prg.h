@@ -38,6 +38,11 @@ public:
     inline unsigned int seed() const
     { return m_seed; }
 
+    // Returns how many numbers were drawn from the engine so far
+    // e.g., the Trial uses it to know whether a step depends on randomness
+    inline unsigned long long draws() const
+    { return m_mteng.draws; }
+
     // Generate a random boolean according to the discrete probability function
     // Where the probability of true is p and the probability of false is (1-p)
     inline bool bernoulli(double p)
@@ -86,8 +91,16 @@ public:
     { return d(m_mteng); }
 
 private:
+    // Mersenne Twister engine which counts the numbers drawn from it
+    struct Engine : public std::mt19937
+    {
+        explicit Engine(unsigned int seed) : std::mt19937(seed), draws(0) {}
+        inline result_type operator()() { ++draws; return std::mt19937::operator()(); }
+        unsigned long long draws;
+    };
+
     const unsigned int m_seed;
-    std::mt19937 m_mteng; //  Mersenne Twister engine
+    Engine m_mteng;
     std::uniform_real_distribution<double> m_doubleZeroOne;
     std::bernoulli_distribution m_bernoulli;
 };
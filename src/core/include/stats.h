@@ -21,6 +21,7 @@
 #ifndef STATS_H
 #define STATS_H
 
+#include <algorithm>
 #include <vector>
 
 #include "attributes.h"
@@ -57,5 +58,113 @@ public:
     }
 };
 
+// Summary statistics of a stream of values computed in a single pass
+// and using constant memory, i.e., the values are not stored.
+// The mean and variance are updated with the Welford's algorithm and
+// the median is estimated with the P-square algorithm (Jain & Chlamtac, 1985),
+// which is exact for up to five values.
+class RunningStats
+{
+public:
+    RunningStats()
+        : m_count(0), m_mean(0.), m_m2(0.), m_min(0.), m_max(0.) {}
+
+    void add(const double x)
+    {
+        ++m_count;
+        const double delta = x - m_mean;
+        m_mean += delta / m_count;
+        m_m2 += delta * (x - m_mean);
+        if (m_count == 1) {
+            m_min = x;
+            m_max = x;
+        } else {
+            m_min = std::min(m_min, x);
+            m_max = std::max(m_max, x);
+        }
+        addToMedian(x);
+    }
+
+    inline int count() const { return m_count; }
+    inline double mean() const { return m_mean; }
+    // sample variance (unbiased)
+    inline double variance() const { return m_count > 1 ? m_m2 / (m_count - 1) : 0.; }
+    inline double min() const { return m_min; }
+    inline double max() const { return m_max; }
+
+    double median() const
+    {
+        if (m_count > 5) {
+            return m_q[2];
+        } else if (m_count == 0) {
+            return 0.;
+        }
+        double q[5];
+        std::copy(m_q, m_q + m_count, q);
+        std::sort(q, q + m_count);
+        const int mid = m_count / 2;
+        return m_count % 2 ? q[mid] : (q[mid-1] + q[mid]) / 2.;
+    }
+
+private:
+    int m_count;
+    double m_mean;
+    double m_m2;
+    double m_min;
+    double m_max;
+    double m_q[5]; // P-square: marker heights
+    int m_n[5];    // P-square: marker positions (1-based)
+
+    void addToMedian(const double x)
+    {
+        if (m_count <= 5) {
+            m_q[m_count-1] = x;
+            if (m_count == 5) {
+                std::sort(m_q, m_q + 5);
+                for (int i = 0; i < 5; ++i) m_n[i] = i + 1;
+            }
+            return;
+        }
+
+        int k; // cell in which x falls
+        if (x < m_q[0]) {
+            m_q[0] = x;
+            k = 0;
+        } else if (x >= m_q[4]) {
+            m_q[4] = x;
+            k = 3;
+        } else {
+            k = 0;
+            while (x >= m_q[k+1]) ++k;
+        }
+        for (int i = k + 1; i < 5; ++i) {
+            ++m_n[i];
+        }
+
+        // adjust the heights of the three middle markers if needed
+        static const double f[5] = {0., .25, .5, .75, 1.};
+        for (int i = 1; i < 4; ++i) {
+            const double d = 1. + (m_count - 1) * f[i] - m_n[i];
+            if ((d >= 1. && m_n[i+1] - m_n[i] > 1) || (d <= -1. && m_n[i-1] - m_n[i] < -1)) {
+                const int ds = d > 0. ? 1 : -1;
+                const double qp = parabolic(i, ds);
+                if (m_q[i-1] < qp && qp < m_q[i+1]) {
+                    m_q[i] = qp;
+                } else {
+                    m_q[i] += ds * (m_q[i+ds] - m_q[i]) / (m_n[i+ds] - m_n[i]);
+                }
+                m_n[i] += ds;
+            }
+        }
+    }
+
+    inline double parabolic(const int i, const int d) const
+    {
+        return m_q[i] + d / static_cast<double>(m_n[i+1] - m_n[i-1])
+                * ((m_n[i] - m_n[i-1] + d) * (m_q[i+1] - m_q[i]) / (m_n[i+1] - m_n[i])
+                 + (m_n[i+1] - m_n[i] - d) * (m_q[i] - m_q[i-1]) / (m_n[i] - m_n[i-1]));
+    }
+};
+
 }
 #endif // STATS_H
@@ -33,6 +33,13 @@ namespace evoplex
 {
 namespace Utils
 {
+    // 64-bit finalizer of the splitmix64 generator
+    inline quint64 mix64(quint64 x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
     template <class T>
     void deleteAndShrink(std::vector<T*>& v) {
         qDeleteAll(v);
@@ -30,9 +30,12 @@ namespace evoplex {
 class Value;
 typedef std::vector<Value> Values;
 
+template<typename T> class NodeAttr;
+
 class Value
 {
     friend struct std::hash<Value>;
+    template<typename T> friend class NodeAttr;
 
 public:
     enum Type { BOOL, CHAR, DOUBLE, INT, STRING, INVALID };
@@ -81,6 +84,11 @@ private:
     Type m_type;
 
     std::logic_error throwError() const;
+
+    // unchecked access to the data, i.e., the caller must ensure that
+    // this Value holds a T (see NodeAttr)
+    template<typename T> inline T get() const;
+    template<typename T> inline void set(T v);
 };
 
 /************************************************************************
@@ -128,6 +136,27 @@ inline quint32 Value::toUInt() const {
     throw throwError();
 }
 
+template<> inline bool Value::get<bool>() const { return m_data.b; }
+template<> inline char Value::get<char>() const { return m_data.c; }
+template<> inline double Value::get<double>() const { return m_data.d; }
+template<> inline int Value::get<int>() const { return m_data.i; }
+// the narrow types (e.g., qint8 for 'int8[0,1]') are held as int or double
+template<> inline qint8 Value::get<qint8>() const { return static_cast<qint8>(m_data.i); }
+template<> inline quint8 Value::get<quint8>() const { return static_cast<quint8>(m_data.i); }
+template<> inline qint16 Value::get<qint16>() const { return static_cast<qint16>(m_data.i); }
+template<> inline quint16 Value::get<quint16>() const { return static_cast<quint16>(m_data.i); }
+template<> inline float Value::get<float>() const { return static_cast<float>(m_data.d); }
+
+template<> inline void Value::set<bool>(bool v) { m_data.b = v; }
+template<> inline void Value::set<char>(char v) { m_data.c = v; }
+template<> inline void Value::set<double>(double v) { m_data.d = v; }
+template<> inline void Value::set<int>(int v) { m_data.i = v; }
+template<> inline void Value::set<qint8>(qint8 v) { m_data.i = v; }
+template<> inline void Value::set<quint8>(quint8 v) { m_data.i = v; }
+template<> inline void Value::set<qint16>(qint16 v) { m_data.i = v; }
+template<> inline void Value::set<quint16>(quint16 v) { m_data.i = v; }
+template<> inline void Value::set<float>(float v) { m_data.d = static_cast<double>(v); }
+
 } // evoplex
 
 
@@ -25,6 +25,7 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QStandardPaths>
 #include <QUrlQuery>
 
 #include "mainapp.h"
@@ -50,6 +51,7 @@ const char* MainApp::kPluginExtension = ".so";
 
 MainApp::MainApp()
     : m_expMgr(new ExperimentsMgr()),
+      m_pluginIndex(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/plugins.json"),
       m_networkMgr(new QNetworkAccessManager())
 {
     qRegisterMetaType<Status>("Status"); // makes it available for signals/slots
@@ -80,10 +82,17 @@ MainApp::MainApp()
     addAttrScope(id, GENERAL_ATTR_AUTODELETE, "bool");
     addAttrScope(id, GENERAL_ATTR_GRAPHTYPE, "string");
     addAttrScope(id, GENERAL_ATTR_EDGEATTRS, "string");
+    addAttrScope(id, GENERAL_ATTR_STEADYSTATE, "int[0,1000]");
+    addAttrScope(id, GENERAL_ATTR_STEADYPAD, "bool");
 
     addAttrScope(id, OUTPUT_DIR, "string");
     addAttrScope(id, OUTPUT_HEADER, "string");
-    // FIXME: addAttrScope(id, OUTPUT_AVGTRIALS, "bool");
+    addAttrScope(id, OUTPUT_STARTAT, QString("int[0,%1]").arg(EVOPLEX_MAX_STEPS));
+    addAttrScope(id, OUTPUT_INTERVAL, QString("int[1,%1]").arg(EVOPLEX_MAX_STEPS));
+    addAttrScope(id, OUTPUT_SAVESTEPS, QString("int[0,%1]").arg(EVOPLEX_MAX_STEPS));
+    addAttrScope(id, OUTPUT_AVGTRIALS, "bool");
+    addAttrScope(id, OUTPUT_FRAMES, "string");
+    addAttrScope(id, OUTPUT_FRAMESINTERVAL, QString("int[1,%1]").arg(EVOPLEX_MAX_STEPS));
 
     QStringList searchPaths;
     searchPaths << qApp->applicationDirPath() + "/lib/evoplex/plugins";
@@ -97,6 +106,9 @@ MainApp::MainApp()
 
     initSystemPlugins();
     initUserPlugins();
+
+    QString error;
+    m_pluginIndex.save(error); // it also forgets the plugins which are gone
 }
 
 MainApp::~MainApp()
@@ -162,7 +174,7 @@ void MainApp::initUserPlugins()
 
 const Plugin* MainApp::loadPlugin(const QString& path, QString& error, const bool addToUserPrefs)
 {
-    Plugin* plugin = Plugin::load(path, error);
+    Plugin* plugin = Plugin::load(path, error, &m_pluginIndex);
     if (!plugin || plugin->type() == PluginType::Invalid) {
         delete plugin;
         return nullptr;
@@ -177,6 +189,22 @@ const Plugin* MainApp::loadPlugin(const QString& path, QString& error, const boo
         return nullptr;
     }
 
+    if (addToUserPrefs) {
+        // the plugins imported by the user are loaded at once, so that
+        // a broken library is reported now instead of when it's used
+        AbstractPlugin* instance = plugin->create();
+        if (!instance) {
+            error = QString("Unable to load the plugin.\n"
+                    "Please, make sure it is a valid Evoplex plugin and that it was"
+                    " built in the same mode (Release or Debug) and architecture "
+                    "(32/64 bits) of Evoplex.\n %1").arg(path);
+            qWarning() << error;
+            delete plugin;
+            return nullptr;
+        }
+        delete instance;
+    }
+
     m_plugins.insert(plugin->key(), plugin);
     if (plugin->type() == PluginType::Graph) {
         m_graphs.insert(plugin->id(), plugin->version());
@@ -188,6 +216,9 @@ const Plugin* MainApp::loadPlugin(const QString& path, QString& error, const boo
         QStringList paths = m_userPrefs.value("plugins").toStringList();
         paths.append(path);
         m_userPrefs.setValue("plugins", paths);
+
+        QString indexError;
+        m_pluginIndex.save(indexError);
     }
 
     emit (pluginAdded(plugin));
@@ -208,6 +239,7 @@ bool MainApp::unloadPlugin(const Plugin* plugin, QString& error)
     QStringList paths = m_userPrefs.value("plugins").toStringList();
     paths.removeOne(plugin->path());
     m_userPrefs.setValue("plugins", paths);
+    m_pluginIndex.remove(plugin->path());
 
     PluginKey key = plugin->key();
     PluginType type = plugin->type();
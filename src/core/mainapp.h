@@ -31,6 +31,7 @@
 
 #include "attributerange.h"
 #include "enum.h"
+#include "pluginindex.h"
 
 class QNetworkAccessManager;
 
@@ -118,6 +119,7 @@ private:
     QDir m_systemPluginsDir;
 
     QSettings m_userPrefs;
+    PluginIndex m_pluginIndex;  // meta data of the plugins, so they are loaded lazily
     quint16 m_defaultStepDelay; // msec
     int m_stepsToFlush;
     bool m_checkUpdatesAtStart;
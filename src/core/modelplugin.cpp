@@ -28,8 +28,8 @@
 
 namespace evoplex {
 
-ModelPlugin::ModelPlugin(QPluginLoader* loader, const QString& libPath)
-    : Plugin(PluginType::Model, loader, libPath)
+ModelPlugin::ModelPlugin(const QJsonObject& metaData, const QString& libPath)
+    : Plugin(PluginType::Model, metaData, libPath)
 {
     if (m_type == PluginType::Invalid) {
         return;
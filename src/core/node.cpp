@@ -24,25 +24,28 @@
 namespace evoplex {
 
 Node::Node()
-    : m_ptr(nullptr)
+    : m_ptr(nullptr),
+      m_attrs(nullptr)
 {}
 
 Node::Node(NodePtr node)
-    : m_ptr(node)
+    : m_ptr(node),
+      m_attrs(node ? &node->m_attrs : nullptr)
 {}
 
 Node::Node(const std::pair<const int, Node>& p)
-    : m_ptr(p.second.m_ptr)
+    : Node(p.second)
 {}
 
 Node::Node(const std::pair<const int, Edge>& p)
-    : m_ptr(p.second.neighbour().m_ptr)
+    : Node(p.second.neighbour())
 {}
 
 Node& Node::operator=(const Node& n)
 {
     if (this != &n) { // check for self-assignment
         m_ptr = n.m_ptr;
+        m_attrs = n.m_attrs;
     }
     return *this;
 }
@@ -68,8 +71,8 @@ float Node::x() const
 float Node::y() const
 { return m_ptr->y(); }
 
-const Attributes& Node::attrs() const
-{ return m_ptr->attrs(); }
+bool Node::hasCoords() const
+{ return m_ptr->hasCoords(); }
 
 const Value& Node::attr(int id) const
 { return m_ptr->attr(id); }
@@ -26,6 +26,7 @@ namespace evoplex {
 
 BaseNode::BaseNode(const constructor_key&, int id, const Attributes& attrs, float x, float y)
     : m_id(id),
+      m_hasCoords(true),
       m_attrs(attrs),
       m_x(x),
       m_y(y)
@@ -33,7 +34,7 @@ BaseNode::BaseNode(const constructor_key&, int id, const Attributes& attrs, floa
 }
 
 BaseNode::BaseNode(const constructor_key& k, int id, const Attributes& attr)
-    : BaseNode(k, id, attr, 0, id) {}
+    : BaseNode(k, id, attr, 0, id) { m_hasCoords = false; }
 
 BaseNode::~BaseNode()
 {
@@ -23,6 +23,7 @@
 
 #include <memory>
 
+#include "arena.h"
 #include "attributes.h"
 #include "edges.h"
 #include "prg.h"
@@ -38,10 +39,12 @@ class NodeInterface
     friend class Nodes;
     friend class TestNode;
     friend class TestEdge;
+    friend class TestForceLayout;
 
 public:
     virtual ~NodeInterface() = default;
-    virtual NodePtr clone() const = 0;
+    // the clone is allocated in the arena (if any)
+    virtual NodePtr clone(const ArenaPtr& arena=nullptr) const = 0;
     virtual const Edges& inEdges() const = 0;
     virtual const Edges& outEdges() const = 0;
     virtual int degree() const = 0;
@@ -68,6 +71,7 @@ private:
 class BaseNode : public NodeInterface
 {
     friend class AbstractGraph;
+    friend class Node;
     friend class NodesPrivate;
     friend class TestNode;
     friend class TestEdge;
@@ -77,10 +81,14 @@ public:
     inline const Value& attr(int id) const;
     inline Value attr(const QString& name, Value defaultValue=Value()) const;
     inline void setAttr(int id, const Value& value);
+    inline Value& attrRef(int id);
 
     inline int id() const;
     inline float x() const;
     inline float y() const;
+    // false if the coordinates were never set, i.e., they are the default
+    // ones (0, id) given to the nodes created without 'x' and 'y'
+    inline bool hasCoords() const;
 
     inline void setX(float x);
     inline void setY(float y);
@@ -99,6 +107,7 @@ protected:
 
 private:
     const int m_id;
+    bool m_hasCoords;
     Attributes m_attrs;
     float m_x;
     float m_y;
@@ -111,7 +120,7 @@ public:
     explicit UNode(const constructor_key& k, int id, const Attributes& attrs);
     ~UNode() override = default;
 
-    inline NodePtr clone() const override;
+    inline NodePtr clone(const ArenaPtr& arena=nullptr) const override;
     inline const Edges& inEdges() const override;
     inline const Edges& outEdges() const override;
     inline int degree() const override;
@@ -134,7 +143,7 @@ public:
     explicit DNode(const constructor_key& k, int id, const Attributes& attrs);
     ~DNode() override = default;
 
-    inline NodePtr clone() const override;
+    inline NodePtr clone(const ArenaPtr& arena=nullptr) const override;
     inline const Edges& inEdges() const override;
     inline const Edges& outEdges() const override;
     inline int degree() const override;
@@ -168,6 +177,9 @@ inline Value BaseNode::attr(const QString& name, Value defaultValue) const
 inline void BaseNode::setAttr(int id, const Value& value)
 { m_attrs.setValue(id, value); }
 
+inline Value& BaseNode::attrRef(int id)
+{ return m_attrs.m_values[static_cast<size_t>(id)]; }
+
 inline int BaseNode::id() const
 { return m_id; }
 
@@ -175,23 +187,29 @@ inline float BaseNode::x() const
 { return m_x; }
 
 inline void BaseNode::setX(float x)
-{ m_x = x; }
+{ m_x = x; m_hasCoords = true; }
 
 inline float BaseNode::y() const
 { return m_y; }
 
 inline void BaseNode::setY(float y)
-{ m_y = y; }
+{ m_y = y; m_hasCoords = true; }
 
 inline void BaseNode::setCoords(float x, float y)
 { setX(x); setY(y); }
 
+inline bool BaseNode::hasCoords() const
+{ return m_hasCoords; }
+
 /************************************************************************
    UNode: Inline member functions
  ************************************************************************/
 
-inline NodePtr UNode::clone() const
-{ return std::make_shared<UNode>(constructor_key(), id(), attrs(), x(), y()); }
+inline NodePtr UNode::clone(const ArenaPtr& arena) const
+{
+    return hasCoords() ? makeShared<UNode>(arena, constructor_key(), id(), attrs(), x(), y())
+                       : makeShared<UNode>(arena, constructor_key(), id(), attrs());
+}
 
 inline const Edges& UNode::inEdges() const
 { return m_outEdges; }
@@ -223,15 +241,20 @@ inline void UNode::removeOutEdge(const int edgeId)
 inline void UNode::clearInEdges()
 { clearOutEdges(); }
 
+// swap to release the buckets, so that the new edges are
+// iterated in the same order as in a new node
 inline void UNode::clearOutEdges()
-{ m_outEdges.clear(); }
+{ Edges().swap(m_outEdges); }
 
 /************************************************************************
    DNode: Inline member functions
  ************************************************************************/
 
-NodePtr DNode::clone() const
-{ return std::make_shared<DNode>(constructor_key(), id(), attrs(), x(), y()); }
+NodePtr DNode::clone(const ArenaPtr& arena) const
+{
+    return hasCoords() ? makeShared<DNode>(arena, constructor_key(), id(), attrs(), x(), y())
+                       : makeShared<DNode>(arena, constructor_key(), id(), attrs());
+}
 
 inline const Edges& DNode::inEdges() const
 { return m_inEdges; }
@@ -261,10 +284,10 @@ inline void DNode::removeOutEdge(const int edgeId)
 { m_outEdges.erase(edgeId); }
 
 inline void DNode::clearInEdges()
-{ m_inEdges.clear(); }
+{ Edges().swap(m_inEdges); }
 
 inline void DNode::clearOutEdges()
-{ m_outEdges.clear(); }
+{ Edges().swap(m_outEdges); }
 
 } // evoplex
 #endif // NODE_P_H
@@ -30,12 +30,12 @@
 
 namespace evoplex {
 
-Nodes NodesPrivate::clone(const Nodes& nodes)
+Nodes NodesPrivate::clone(const Nodes& nodes, const ArenaPtr& arena)
 {
     Nodes ret;
     ret.reserve(nodes.size());
     for (auto const& pair : nodes) {
-        ret.insert({pair.first, pair.second.clone()});
+        ret.insert({pair.first, pair.second.m_ptr->clone(arena)});
     }
     return ret;
 }
@@ -60,14 +60,14 @@ Nodes NodesPrivate::fromCmd(const QString& cmd, const AttributesScope& attrsScop
     if (graphType == GraphType::Directed) {
         for (Attributes attrs : setOfAttrs) {
             Node node;
-            node.m_ptr = std::make_shared<DNode>(k, id, attrs);
+            node = Node(std::make_shared<DNode>(k, id, attrs));
             nodes.insert({id, node});
             ++id;
         }
     } else if (graphType == GraphType::Undirected) {
         for (Attributes attrs : setOfAttrs) {
             Node node;
-            node.m_ptr = std::make_shared<UNode>(k, id, attrs);
+            node = Node(std::make_shared<UNode>(k, id, attrs));
             nodes.insert({id, node});
             ++id;
         }
@@ -208,6 +208,7 @@ Node NodesPrivate::readRow(const int row, const QStringList& header, const QStri
     }
 
     AttributeRangePtr attrRange;
+    bool hasCoords = false;
     float coordX = 0.f;
     float coordY = row;
     Attributes attrs(attrsScope.size());
@@ -215,8 +216,10 @@ Node NodesPrivate::readRow(const int row, const QStringList& header, const QStri
         bool isValid = true;
         if (header.at(col) == "x") {
             coordX = values.at(col).toFloat(&isValid);
+            hasCoords = true;
         } else if (header.at(col) == "y") {
             coordY = values.at(col).toFloat(&isValid);
+            hasCoords = true;
         } else {
             attrRange = attrsScope.value(header.at(col), nullptr);
             if (attrRange) { // is null if the column is not required
@@ -241,10 +244,14 @@ Node NodesPrivate::readRow(const int row, const QStringList& header, const QStri
 
     Node node;
     BaseNode::constructor_key k;
+    // without 'x' and 'y', the node keeps the default coordinates, so that
+    // the GUI knows that it must lay out the graph (see ForceLayout)
     if (isDirected) {
-        node.m_ptr = std::make_shared<DNode>(k, row, attrs, coordX, coordY);
+        node = Node(hasCoords ? std::make_shared<DNode>(k, row, attrs, coordX, coordY)
+                              : std::make_shared<DNode>(k, row, attrs));
     } else {
-        node.m_ptr = std::make_shared<UNode>(k, row, attrs, coordX, coordY);
+        node = Node(hasCoords ? std::make_shared<UNode>(k, row, attrs, coordX, coordY)
+                              : std::make_shared<UNode>(k, row, attrs));
     }
     return node;
 }
@@ -24,6 +24,7 @@
 #include <functional>
 #include <unordered_map>
 
+#include "arena.h"
 #include "attributerange.h"
 #include "enum.h"
 #include "nodes.h"
@@ -54,7 +55,8 @@ public:
                            std::function<void(int)> progress = [](int){});
 
     // clone a Nodes container
-    static Nodes clone(const Nodes& nodes);
+    // the new nodes are allocated in the arena (if any)
+    static Nodes clone(const Nodes& nodes, const ArenaPtr& arena=nullptr);
 
 private:
     // Checks if the header is in comma-separated format,
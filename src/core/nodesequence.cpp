@@ -0,0 +1,83 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <limits>
+
+#include "nodesequence.h"
+#include "utils.h"
+
+namespace evoplex {
+
+RandomPermutation::RandomPermutation(quint64 n, PRG* prg)
+    : m_n(n),
+      m_halfBits(1)
+{
+    // the domain has 2*halfBits bits, ie., it's a power of four >= n
+    while (m_halfBits < 32 && (quint64(1) << (2 * m_halfBits)) < n) {
+        ++m_halfBits;
+    }
+    m_halfMask = (quint64(1) << m_halfBits) - 1;
+    for (quint64& k : m_keys) {
+        k = prg ? prg->uniform(size_t(0), std::numeric_limits<size_t>::max()) : 0;
+    }
+}
+
+quint64 RandomPermutation::encrypt(quint64 x) const
+{
+    quint64 left = x >> m_halfBits;
+    quint64 right = x & m_halfMask;
+    for (const quint64 k : m_keys) {
+        const quint64 tmp = right;
+        right = left ^ (Utils::mix64(right ^ k) & m_halfMask);
+        left = tmp;
+    }
+    return (left << m_halfBits) | right;
+}
+
+quint64 RandomPermutation::at(quint64 i) const
+{
+    Q_ASSERT_X(i < m_n, "RandomPermutation", "index out of range");
+    // cycle-walking: the domain is at most 4n, so it takes < 4 rounds on average
+    quint64 x = encrypt(i);
+    while (x >= m_n) {
+        x = encrypt(x);
+    }
+    return x;
+}
+
+NodeSequence::NodeSequence(const std::vector<Node>* nodes, PRG* prg)
+    : m_nodes(nodes),
+      m_prg(prg),
+      m_replacement(false),
+      m_size(nodes->size()),
+      m_perm(nodes->size(), prg)
+{
+}
+
+NodeSequence::NodeSequence(const std::vector<Node>* nodes, PRG* prg, quint64 n)
+    : m_nodes(nodes),
+      m_prg(prg),
+      m_replacement(true),
+      m_size(nodes->empty() ? 0 : n),
+      m_perm(0, nullptr)
+{
+}
+
+} // evoplex
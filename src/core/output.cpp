@@ -19,7 +19,11 @@
  */
 
 #include <QDebug>
+#include <QFile>
 #include <QStringList>
+#include <QTextStream>
+#include <iterator>
+#include <limits>
 
 #include "output.h"
 #include "trial.h"
@@ -31,6 +35,7 @@ namespace evoplex
 Cache::Cache(const Values& inputs, const std::vector<int>& trialIds, OutputPtr parent)
     : m_parent(parent)
     , m_inputs(inputs)
+    , m_maxRows(0)
 {
     Q_ASSERT_X(!m_inputs.empty(), "Cache", "inputs cannot be empty");
     for (int trialId : trialIds) {
@@ -45,6 +50,7 @@ void Cache::deleteCache()
 
 bool Cache::isEmpty(const int trialId) const
 {
+    QMutexLocker locker(&m_mutex);
     std::unordered_map<int, Data>::const_iterator trial = m_trials.find(trialId);
     if (trial != m_trials.end()) {
         return trial->second.rows.empty();
@@ -58,13 +64,58 @@ QString Cache::printableHeader(const char sep, const bool joinInputs) const
                                    m_inputs, sep, joinInputs);
 }
 
+void Cache::flushFrontRow(const int trialId)
+{
+    QMutexLocker locker(&m_mutex);
+    Data& data = m_trials.at(trialId);
+    data.rows.pop_front();
+    --data.numRows;
+}
+
 void Cache::flushAll()
 {
+    QMutexLocker locker(&m_mutex);
     for (auto& it : m_trials) {
         it.second.rows.clear();
+        it.second.numRows = 0;
     }
 }
 
+int Cache::takeRows(const int trialId, std::vector<Row>& rows, const int maxRows)
+{
+    std::forward_list<Row> taken;
+    int n = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto trial = m_trials.find(trialId);
+        if (trial == m_trials.end() || trial->second.rows.empty()) {
+            return 0;
+        }
+
+        Data& data = trial->second;
+        if (maxRows <= 0 || data.numRows <= maxRows) {
+            n = data.numRows;
+            taken.swap(data.rows);
+            data.numRows = 0;
+        } else {
+            auto last = data.rows.cbegin();
+            for (n = 1; n < maxRows; ++n) {
+                ++last;
+            }
+            taken.splice_after(taken.cbefore_begin(), data.rows,
+                               data.rows.cbefore_begin(), std::next(last));
+            data.numRows -= n;
+        }
+    }
+
+    // the rows are moved out of the lock
+    rows.reserve(rows.size() + static_cast<size_t>(n));
+    for (Row& row : taken) {
+        rows.emplace_back(std::move(row));
+    }
+    return n;
+}
+
 /*******************************************************/
 /*******************************************************/
 
@@ -80,25 +131,18 @@ DefaultOutput::DefaultOutput(Function f, Entity e, AttributeRangePtr attrRange)
                         m_attrRange->attrName());
 }
 
-void DefaultOutput::doOperation(const Trial* trial)
+Values DefaultOutput::allValues(const Trial* trial) const
 {
-    if (m_allTrialIds.find(trial->id()) == m_allTrialIds.end()) {
-        return;
-    }
-
-    Values allValues;
     switch (m_func) {
     case F_Count:
         if (m_entity == E_Nodes) {
-            allValues = Stats::count(trial->graph()->nodes(), m_attrRange->id(), m_allInputs);
-        } else {
-            allValues = Stats::count(trial->graph()->edges(), m_attrRange->id(), m_allInputs);
+            return Stats::count(trial->graph()->nodes(), m_attrRange->id(), m_allInputs);
         }
-        break;
+        return Stats::count(trial->graph()->edges(), m_attrRange->id(), m_allInputs);
     default:
         qFatal("invalid function!");
     }
-    updateCaches(trial->id(), trial->step(), allValues);
+    return Values();
 }
 
 bool DefaultOutput::operator==(const OutputPtr output) const
@@ -119,12 +163,9 @@ CustomOutput::CustomOutput() : Output()
     m_headerPrefix = "custom_";
 }
 
-void CustomOutput::doOperation(const Trial* trial)
+Values CustomOutput::allValues(const Trial* trial) const
 {
-    if (m_allTrialIds.find(trial->id()) == m_allTrialIds.end()) {
-        return;
-    }
-    updateCaches(trial->id(), trial->step(), trial->model()->customOutputs(m_allInputs));
+    return trial->model()->customOutputs(m_allInputs);
 }
 
 bool CustomOutput::operator==(const OutputPtr output) const
@@ -142,6 +183,91 @@ bool CustomOutput::operator==(const OutputPtr output) const
 /*******************************************************/
 /*******************************************************/
 
+TrialsAggregator::TrialsAggregator(const QString& filePath, const int numTrials)
+    : m_filePath(filePath)
+    , m_numTrials(numTrials)
+{
+}
+
+QString TrialsAggregator::printableHeader(const QString& column, const char sep)
+{
+    QString ret;
+    for (const char* stat : {"mean", "var", "min", "max", "median"}) {
+        ret += column + "_" + stat + sep;
+    }
+    ret.chop(1);
+    return ret;
+}
+
+bool TrialsAggregator::init(const QString& header, QString& errorMsg)
+{
+    QMutexLocker locker(&m_mutex);
+    m_rows.clear();
+    QFile file(m_filePath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        errorMsg = QString("unable to aggregate the trials. Could not write in %1").arg(m_filePath);
+        return false;
+    }
+    QTextStream stream(&file);
+    stream << header;
+    file.close();
+    return true;
+}
+
+void TrialsAggregator::addRow(const int step, const Values& values)
+{
+    QMutexLocker locker(&m_mutex);
+    std::vector<RunningStats>& cols = m_rows[step];
+    if (cols.empty()) {
+        cols.resize(values.size());
+    }
+    Q_ASSERT_X(cols.size() == values.size(), "TrialsAggregator",
+               "all rows must have the same number of columns");
+    for (size_t i = 0; i < values.size(); ++i) {
+        const Value& v = values[i];
+        switch (v.type()) {
+        case Value::DOUBLE: cols[i].add(v.toDouble()); break;
+        case Value::INT: cols[i].add(v.toInt()); break;
+        case Value::BOOL: cols[i].add(v.toBool()); break;
+        default: cols[i].add(std::numeric_limits<double>::quiet_NaN());
+        }
+    }
+}
+
+bool TrialsAggregator::writeRows(const bool all)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_rows.empty() || (!all && m_rows.begin()->second.front().count() < m_numTrials)) {
+        return true;
+    }
+
+    QFile file(m_filePath);
+    if (!file.open(QFile::WriteOnly | QFile::Append)) {
+        qWarning() << "unable to aggregate the trials. Could not write in " << m_filePath;
+        return false;
+    }
+
+    QTextStream stream(&file);
+    // rows are sorted by step, so we stop at the first incomplete one
+    auto it = m_rows.begin();
+    while (it != m_rows.end() && (all || it->second.front().count() >= m_numTrials)) {
+        QString row = QString("%1,%2").arg(it->first).arg(it->second.front().count());
+        for (const RunningStats& col : it->second) {
+            for (double v : {col.mean(), col.variance(), col.min(), col.max(), col.median()}) {
+                row += "," + QString::number(v, 'g', 10);
+            }
+        }
+        stream << row << "\n";
+        it = m_rows.erase(it);
+    }
+
+    file.close();
+    return true;
+}
+
+/*******************************************************/
+/*******************************************************/
+
 Output::~Output()
 {
     for (Cache* c :  m_caches) {
@@ -149,6 +275,20 @@ Output::~Output()
     }
 }
 
+void Output::doOperation(const Trial* trial)
+{
+    if (m_allTrialIds.find(trial->id()) != m_allTrialIds.end()) {
+        updateCaches(trial->id(), trial->step(), allValues(trial));
+    }
+}
+
+void Output::doOperation(const Trial* trial, const Values& values)
+{
+    if (m_allTrialIds.find(trial->id()) != m_allTrialIds.end()) {
+        updateCaches(trial->id(), trial->step(), values);
+    }
+}
+
 void Output::flushAll()
 {
     for (Cache* c : m_caches) {
@@ -215,8 +355,17 @@ void Output::updateCaches(const int trialId, const int currStep, const Values& a
             const size_t col = std::find(m_allInputs.begin(), m_allInputs.end(), input) - m_allInputs.begin();
             newRow.second.emplace_back(allValues.at(col));
         }
+
+        QMutexLocker locker(&cache->m_mutex);
         if (data.rows.empty()) data.last = data.rows.before_begin();
         data.last = data.rows.emplace_after(data.last, newRow);
+        ++data.numRows;
+
+        // rolling buffer: drop the oldest row
+        if (cache->m_maxRows > 0 && data.numRows > cache->m_maxRows) {
+            data.rows.pop_front();
+            --data.numRows;
+        }
     }
 }
 
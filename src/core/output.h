@@ -22,10 +22,12 @@
 #define OUTPUT_H
 
 #include <forward_list>
+#include <map>
 #include <memory>
 #include <set>
 #include <unordered_map>
 #include <vector>
+#include <QMutex>
 
 #include "attributes.h"
 #include "attributerange.h"
@@ -57,24 +59,81 @@ public:
 
     inline OutputPtr output() const { return m_parent; }
     inline const Values& inputs() const { return m_inputs; }
+
+    // CAUTION! The row might be flushed by a running trial (rolling buffer).
+    // Call it only from the thread which runs the trial or when it's paused.
     inline const Row& readFrontRow(const int trialId) const { return m_trials.at(trialId).rows.front(); }
-    inline void flushFrontRow(const int trialId) { m_trials.at(trialId).rows.pop_front(); }
+    void flushFrontRow(const int trialId);
     void flushAll();
 
+    // Moves up to 'maxRows' (0 for all) of the oldest rows of the trial to 'rows'.
+    // Unlike 'readFrontRow()', it's safe to call it while the trial runs,
+    // as the rows are taken at once (eg, by the GUI).
+    // Returns the number of rows taken.
+    int takeRows(const int trialId, std::vector<Row>& rows, const int maxRows);
+
+    // Maximum number of rows kept for each trial (rolling buffer).
+    // When it's full, the oldest row is discarded to give room to the new one.
+    // n=0 to keep all rows (default)
+    inline int maxRows() const { return m_maxRows; }
+    inline void setMaxRows(int n) { m_maxRows = n < 0 ? 0 : n; }
+
 private:
     struct Data {
         std::forward_list<Row> rows;
         std::forward_list<Row>::const_iterator last;
+        int numRows = 0;
     };
 
     OutputPtr m_parent;
     Values m_inputs; // columns
+    int m_maxRows;
     std::unordered_map<int, Data> m_trials;
+    mutable QMutex m_mutex; // held just to insert or take rows
 
     // let's keep it private to ensure that only Output can create a Cache
     explicit Cache(const Values& inputs, const std::vector<int>& trialIds, OutputPtr parent);
 };
 
+// Merges the rows of all trials of an experiment into a single summary,
+// step by step, as the trials progress (OUTPUT_AVGTRIALS).
+// Each column is summarised by its mean, variance, min, max and median.
+// A row is written to file as soon as all trials have contributed to it.
+// Until then, it takes about 100 bytes per column (see RunningStats),
+// whatever the number of trials. But the trials which do not fit in the
+// thread pool only start when others finish, so, with more trials than
+// threads, the rows of all saved steps might be held until the last trial
+// catches up.
+class TrialsAggregator
+{
+public:
+    explicit TrialsAggregator(const QString& filePath, const int numTrials);
+
+    // Printable header with all statistics of a column separated by 'sep'.
+    // eg: column_mean[sep]column_var[sep]column_min[sep]column_max[sep]column_median
+    static QString printableHeader(const QString& column, const char sep);
+
+    // creates (or truncates) the file and writes the header
+    bool init(const QString& header, QString& errorMsg);
+
+    // merges the row of values obtained by a trial at a given step
+    // this method is thread-safe
+    void addRow(const int step, const Values& values);
+
+    // Writes the rows which are complete (i.e., all trials contributed to them)
+    // and releases their memory. If 'all' is true, incomplete rows are written too.
+    // this method is thread-safe
+    bool writeRows(const bool all);
+
+    inline const QString& filePath() const { return m_filePath; }
+
+private:
+    const QString m_filePath;
+    const int m_numTrials;
+    QMutex m_mutex;
+    std::map<int, std::vector<RunningStats>> m_rows; // <step, columns>
+};
+
 class Output : public std::enable_shared_from_this<Output>
 {
 public:
@@ -86,7 +145,15 @@ public:
 
     virtual ~Output();
 
-    virtual void doOperation(const Trial* trial) = 0;
+    // Caches the values of all inputs in the current step of the trial.
+    void doOperation(const Trial* trial);
+
+    // Caches the given values (see allValues()) as the ones of the current
+    // step of the trial, e.g., to pad the outputs of a trial in a steady state.
+    void doOperation(const Trial* trial, const Values& values);
+
+    // the values of all inputs in the current step of the trial
+    virtual Values allValues(const Trial* trial) const = 0;
 
     // Printable header with all columns of this operation separated by 'sep'.
     // If joinInputs is enabled: eg: func_attr_input1[sep]input2
@@ -133,7 +200,7 @@ class CustomOutput: public Output
 public:
     explicit CustomOutput();
 
-    virtual void doOperation(const Trial* trial);
+    virtual Values allValues(const Trial* trial) const;
 
     virtual bool operator==(const OutputPtr output) const;
 };
@@ -165,7 +232,7 @@ public:
 
     explicit DefaultOutput(Function f, Entity e, AttributeRangePtr attrRange);
 
-    virtual void doOperation(const Trial* trial);
+    virtual Values allValues(const Trial* trial) const;
 
     virtual bool operator==(const OutputPtr output) const;
 
@@ -29,6 +29,7 @@
 #include "plugin.h"
 #include "graphplugin.h"
 #include "modelplugin.h"
+#include "pluginindex.h"
 #include "constants.h"
 #include "utils.h"
 
@@ -76,55 +77,32 @@ bool Plugin::checkMetaData(const QJsonObject& metaData, QString& error)
     return true;
 }
 
-Plugin* Plugin::load(const QString& path, QString& error)
+Plugin* Plugin::load(const QString& path, QString& error, PluginIndex* index)
 {
-    QFile file(path);
-    if (!file.exists()) {
+    if (!QFileInfo::exists(path)) {
         error = "Unable to find the file. " + path;
         qWarning() << error;
         return nullptr;
     }
 
-    // we should NEVER load the plugin from the original path
-    // instead, we make a copy of the plugin to the temporary dir
-    // it allows us to safely unload and reload plugins later on
-    QString tempPath = path;
-    QString fname = QFileInfo(file).fileName();
-    while (QFile::exists(tempPath)) {
-        tempPath = QDir::temp().absoluteFilePath(
-                QString("evoplex_%1%2").arg(rand()).arg(fname));
-    }
-    if (!file.copy(tempPath)) {
-        error = "Unable make a temporary copy of the file " + path;
-        qWarning() << error;
-        return nullptr;
+    // reading the meta data does not load the library
+    QJsonObject metaData = index ? index->metaData(path) : QJsonObject();
+    const bool indexed = !metaData.isEmpty();
+    if (!indexed) {
+        metaData = QPluginLoader(path).metaData().value("MetaData").toObject();
     }
-
-    QPluginLoader* loader = new QPluginLoader(tempPath);
-    QJsonObject metaData = loader->metaData().value("MetaData").toObject();
     if (!checkMetaData(metaData, error)) {
         error += QString("\n+%1").arg(path);
         qWarning() << error;
         return nullptr;
     }
 
-    QObject* instance = loader->instance(); // it'll load the plugin
-    if (!instance) {
-        error = QString("Unable to load the plugin.\n"
-                "Please, make sure it is a valid Evoplex plugin and that it was"
-                " built in the same mode (Release or Debug) and architecture "
-                "(32/64 bits) of Evoplex.\n %1").arg(path);
-        loader->unload();
-        qWarning() << error;
-        return nullptr;
-    }
-
     Plugin* plugin = nullptr;
     const PluginType type = _enumFromString<PluginType>(metaData[PLUGIN_ATTR_TYPE].toString());
     if (type == PluginType::Graph) {
-        plugin = new GraphPlugin(loader, path);
+        plugin = new GraphPlugin(metaData, path);
     } else if (type == PluginType::Model) {
-        plugin = new ModelPlugin(loader, path);
+        plugin = new ModelPlugin(metaData, path);
     }
 
     if (!plugin || plugin->type() == PluginType::Invalid) {
@@ -135,17 +113,20 @@ Plugin* Plugin::load(const QString& path, QString& error)
         return nullptr;
     }
 
+    if (index && !indexed) {
+        index->insert(path, metaData);
+    }
     return plugin;
 }
 
-Plugin::Plugin(PluginType type, QPluginLoader* loader, const QString& libPath)
+Plugin::Plugin(PluginType type, const QJsonObject& metaData, const QString& libPath)
     : m_type(type),
-      m_loader(loader),
+      m_metaData(metaData),
+      m_loader(nullptr),
       m_factory(nullptr),
       m_libPath(libPath),
       m_version(0)
 {
-    m_metaData = m_loader->metaData().value("MetaData").toObject();
     m_id = m_metaData.value(PLUGIN_ATTR_UID).toString();
     m_author = m_metaData.value(PLUGIN_ATTR_AUTHOR).toString();
     m_title = m_metaData.value(PLUGIN_ATTR_TITLE).toString();
@@ -172,35 +153,89 @@ Plugin::Plugin(PluginType type, QPluginLoader* loader, const QString& libPath)
         return;
     }
 
-    m_factory = qobject_cast<PluginInterface*>(m_loader->instance());
-    if (!m_factory) {
-        qWarning() << QString("factory could not be created for '%1'").arg(m_title);
-        m_type = PluginType::Invalid;
-        return;
-    }
-
     // build the compactMetaData without the general keys
-    auto metaData = m_metaData;
+    auto compactMetaData = m_metaData;
     QStringList removeKeys = {
         PLUGIN_ATTR_TYPE, PLUGIN_ATTR_UID, PLUGIN_ATTR_AUTHOR,
         PLUGIN_ATTR_TITLE, PLUGIN_ATTR_DESCRIPTION, PLUGIN_ATTR_VERSION };
     for (auto const& k : removeKeys) {
-        metaData.remove(k);
+        compactMetaData.remove(k);
     }
-    if (!metaData.isEmpty()) {
-        QJsonDocument doc(metaData);
+    if (!compactMetaData.isEmpty()) {
+        QJsonDocument doc(compactMetaData);
         m_compactMetaData = doc.toJson(QJsonDocument::Indented);
     }
 }
 
 Plugin::~Plugin()
 {
+    if (!m_loader) {
+        return; // never loaded
+    }
     if (!m_loader->unload() || !QFile::remove(m_loader->fileName())) {
         qWarning() << "failed to remove the plugin";
     }
     delete m_loader;
 }
 
+AbstractPlugin* Plugin::create() const
+{
+    QMutexLocker locker(&m_loaderMutex);
+    if (!m_factory && !loadLibrary()) {
+        return nullptr;
+    }
+    return m_factory->create();
+}
+
+bool Plugin::loadLibrary() const
+{
+    // we should NEVER load the plugin from the original path
+    // instead, we make a copy of the plugin to the temporary dir
+    // it allows us to safely unload and reload plugins later on
+    QFile file(m_libPath);
+    QString tempPath = m_libPath;
+    QString fname = QFileInfo(file).fileName();
+    while (QFile::exists(tempPath)) {
+        tempPath = QDir::temp().absoluteFilePath(
+                QString("evoplex_%1%2").arg(rand()).arg(fname));
+    }
+    if (!file.copy(tempPath)) {
+        qWarning() << "Unable make a temporary copy of the file " + m_libPath;
+        return false;
+    }
+
+    QPluginLoader* loader = new QPluginLoader(tempPath);
+    auto discard = [loader, &tempPath]() {
+        loader->unload();
+        delete loader;
+        QFile::remove(tempPath);
+    };
+
+    // the library might have been replaced since its meta data was read
+    const QJsonObject metaData = loader->metaData().value("MetaData").toObject();
+    if (metaData.value(PLUGIN_ATTR_UID).toString() != m_id ||
+            metaData.value(PLUGIN_ATTR_VERSION).toInt(-1) != m_version) {
+        qWarning() << QString("Unable to load the plugin '%1'.\n"
+                "The library has changed since it was imported; please, reload it.\n %2")
+                .arg(m_title, m_libPath);
+        discard();
+        return false;
+    }
+
+    m_factory = qobject_cast<PluginInterface*>(loader->instance()); // it'll load the plugin
+    if (!m_factory) {
+        qWarning() << QString("Unable to load the plugin.\n"
+                "Please, make sure it is a valid Evoplex plugin and that it was"
+                " built in the same mode (Release or Debug) and architecture "
+                "(32/64 bits) of Evoplex.\n %1").arg(m_libPath);
+        discard();
+        return false;
+    }
+
+    m_loader = loader;
+    return true;
+}
+
 bool Plugin::readAttrsScope(const QString& attrName, AttributesScope& attrsScope,
                             std::vector<QString>& keys) const
 {
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include <QJsonObject>
+#include <QMutex>
 #include <QString>
 #include <QPluginLoader>
 
@@ -34,6 +35,8 @@
 
 namespace evoplex {
 
+class PluginIndex;
+
 using PluginKey = std::pair<QString, quint16>;  // <id, version>
 
 class Plugin
@@ -44,9 +47,13 @@ public:
     // converts a key pair to a formated string
     static QString keyStr(const PluginKey& key);
 
-    static Plugin* load(const QString& path, QString& error);
+    // The meta data is read from the 'index' (if it's up to date) or from
+    // the library, which is only loaded in the first call to 'create()'.
+    static Plugin* load(const QString& path, QString& error, PluginIndex* index=nullptr);
 
-    inline AbstractPlugin* create() const;
+    // Loads the library in the first call.
+    // Returns nullptr if the library could not be loaded.
+    AbstractPlugin* create() const;
 
     // The plugin's key is used to identify this plugin internally
     inline const PluginKey& key() const;
@@ -70,17 +77,18 @@ protected:
     QJsonObject m_metaData;
 
     /**
-     * Relies that any plugin lugin is loaded from the temporary directory
+     * @param metaData refers to the 'MetaData' object of the plugin's library
      * @param libPath refers to the original plugin's path
      */
-    explicit Plugin(PluginType type, QPluginLoader* loader, const QString& libPath);
+    explicit Plugin(PluginType type, const QJsonObject& metaData, const QString& libPath);
 
     bool readAttrsScope(const QString& attrName, AttributesScope& attrsScope,
                         std::vector<QString>& keys) const;
 
 private:
-    QPluginLoader* m_loader;
-    PluginInterface* m_factory;
+    mutable QMutex m_loaderMutex;
+    mutable QPluginLoader* m_loader;    // nullptr until 'create()' is called
+    mutable PluginInterface* m_factory;
     const QString m_libPath;
     QString m_compactMetaData;
     PluginKey m_key;
@@ -93,10 +101,10 @@ private:
     std::vector<QString> m_pluginAttrsNames;
 
     static bool checkMetaData(const QJsonObject& metaData, QString& error);
-};
 
-inline AbstractPlugin* Plugin::create() const
-{ return m_factory->create(); }
+    // Loads a temporary copy of the library; m_loaderMutex must be locked.
+    bool loadLibrary() const;
+};
 
 inline const PluginKey& Plugin::key() const
 { return m_key; }
@@ -0,0 +1,140 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+#include "pluginindex.h"
+
+namespace evoplex {
+
+namespace {
+// bumped whenever the layout of the entries changes
+const int kIndexVersion = 1;
+}
+
+PluginIndex::PluginIndex(const QString& filePath)
+    : m_filePath(filePath),
+      m_changed(false)
+{
+    QFile file(m_filePath);
+    if (!file.open(QFile::ReadOnly)) {
+        return; // nothing indexed yet
+    }
+
+    const QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+    if (json.value("version").toInt() == kIndexVersion) {
+        m_entries = json.value("plugins").toObject();
+    } else {
+        qWarning() << "discarding an outdated plugin index" << m_filePath;
+        m_changed = true;
+    }
+}
+
+QString PluginIndex::key(const QString& libPath)
+{
+    return QFileInfo(libPath).absoluteFilePath();
+}
+
+QJsonObject PluginIndex::metaData(const QString& libPath)
+{
+    const QString k = key(libPath);
+    const QJsonObject entry = m_entries.value(k).toObject();
+    if (entry.isEmpty()) {
+        return QJsonObject();
+    }
+
+    const QFileInfo fi(k);
+    if (!fi.exists() || entry.value("size").toDouble() != fi.size()
+            || entry.value("lastModified").toDouble() != fi.lastModified().toMSecsSinceEpoch()) {
+        m_entries.remove(k);
+        m_changed = true;
+        return QJsonObject();
+    }
+
+    m_used.insert(k);
+    return entry.value("metaData").toObject();
+}
+
+void PluginIndex::insert(const QString& libPath, const QJsonObject& metaData)
+{
+    const QString k = key(libPath);
+    const QFileInfo fi(k);
+    QJsonObject entry;
+    // the size and time are stored as doubles (exact up to 2^53)
+    entry.insert("size", static_cast<double>(fi.size()));
+    entry.insert("lastModified", static_cast<double>(fi.lastModified().toMSecsSinceEpoch()));
+    entry.insert("metaData", metaData);
+    m_entries.insert(k, entry);
+    m_used.insert(k);
+    m_changed = true;
+}
+
+void PluginIndex::remove(const QString& libPath)
+{
+    const QString k = key(libPath);
+    if (m_entries.contains(k)) {
+        m_entries.remove(k);
+        m_changed = true;
+    }
+    m_used.remove(k);
+}
+
+bool PluginIndex::save(QString& error)
+{
+    for (const QString& k : m_entries.keys()) {
+        if (!m_used.contains(k)) {
+            m_entries.remove(k);
+            m_changed = true;
+        }
+    }
+
+    if (!m_changed) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    QSaveFile file(m_filePath);
+    if (!file.open(QFile::WriteOnly)) {
+        error = "Unable to write the plugin index. " + m_filePath;
+        qWarning() << error;
+        return false;
+    }
+
+    QJsonObject json;
+    json.insert("version", kIndexVersion);
+    json.insert("plugins", m_entries);
+    file.write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        error = "Unable to write the plugin index. " + m_filePath;
+        qWarning() << error;
+        return false;
+    }
+
+    m_changed = false;
+    return true;
+}
+
+} // evoplex
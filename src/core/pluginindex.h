@@ -0,0 +1,71 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLUGININDEX_H
+#define PLUGININDEX_H
+
+#include <QJsonObject>
+#include <QSet>
+#include <QString>
+
+namespace evoplex {
+
+/**
+ * @brief A persistent index of the plugins' meta data.
+ *
+ * Reading the meta data of a plugin means reading its library, and loading
+ * it means copying the library to the temporary dir and opening it. This
+ * index keeps the meta data of each library keyed by its path, size and
+ * last modification, so that the plugins can be listed at start-up without
+ * touching the libraries; they are only loaded when used.
+ *
+ * @see Plugin::load(), Plugin::create()
+ */
+class PluginIndex
+{
+public:
+    // Reads the index from 'filePath' (if any).
+    explicit PluginIndex(const QString& filePath);
+
+    inline const QString& filePath() const { return m_filePath; }
+    inline int size() const { return m_entries.size(); }
+
+    // Returns the meta data of the library at 'libPath', or an empty object
+    // if it's not in the index or if the library has changed since then.
+    QJsonObject metaData(const QString& libPath);
+
+    void insert(const QString& libPath, const QJsonObject& metaData);
+    void remove(const QString& libPath);
+
+    // Writes the index to the file (if it has changed), without the entries
+    // which were neither read nor inserted since the index was opened.
+    bool save(QString& error);
+
+private:
+    const QString m_filePath;
+    QJsonObject m_entries;  // absolute path -> {size, lastModified, metaData}
+    QSet<QString> m_used;   // entries read or inserted since opened
+    bool m_changed;
+
+    static QString key(const QString& libPath);
+};
+
+} // evoplex
+#endif // PLUGININDEX_H
@@ -0,0 +1,90 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "snapshot.h"
+
+namespace evoplex {
+
+NodesSnapshot::NodesSnapshot(const int attrId, const int stepInterval)
+    : m_attrId(attrId),
+      m_stepInterval(stepInterval),
+      m_back(0),
+      m_lastStep(-1),
+      m_prev(-1),
+      m_front(1),
+      m_middle(2)
+{
+}
+
+bool NodesSnapshot::acquire()
+{
+    if (!(m_middle.load(std::memory_order_relaxed) & FreshBit)) {
+        return false;
+    }
+    // takes the fresh frame and gives the old front one back to the writer
+    m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & ~FreshBit;
+    return true;
+}
+
+void NodesSnapshot::publish(const Nodes& nodes, const int step)
+{
+    Frame& frame = m_frames[m_back];
+    frame.step = step;
+    m_lastStep = step;
+
+    // The changes are listed against the previous frame, which is never
+    // written while it's in the middle or in the front. If the reader has
+    // not taken it yet, it will be skipped, so its changes are carried over
+    // (if it's taken meanwhile, we just list a few more ids than needed).
+    const Frame* prev = m_prev < 0 ? nullptr : &m_frames[m_prev];
+    const bool carry = prev && (m_middle.load(std::memory_order_acquire) & FreshBit);
+    const size_t maxChanged = nodes.size() / 4;
+    frame.allChanged = !prev || (carry && (prev->allChanged || prev->changed.size() > maxChanged));
+    frame.changed.clear();
+    if (carry && !frame.allChanged) {
+        frame.changed = prev->changed;
+    }
+
+    // the ids are usually in [0, nodes.size()), but there might be gaps
+    // when the model removes nodes; such ids are never read
+    if (frame.values.size() < nodes.size()) {
+        frame.values.resize(nodes.size());
+    }
+    for (auto const& np : nodes) {
+        const size_t id = static_cast<size_t>(np.first);
+        if (id >= frame.values.size()) {
+            frame.values.resize(id + 1);
+        }
+        const Value& value = np.second.attr(m_attrId);
+        if (!frame.allChanged && (id >= prev->values.size() || !(prev->values[id] == value))) {
+            frame.changed.emplace_back(np.first);
+            if (frame.changed.size() > maxChanged) {
+                frame.allChanged = true; // the reader would rather take it all
+                frame.changed.clear();
+            }
+        }
+        frame.values[id] = value;
+    }
+
+    m_prev = m_back;
+    m_back = m_middle.exchange(m_back | FreshBit, std::memory_order_acq_rel) & ~FreshBit;
+}
+
+} // evoplex
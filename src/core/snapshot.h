@@ -0,0 +1,128 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <QtGlobal>
+
+#include "nodes.h"
+#include "value.h"
+
+namespace evoplex {
+
+class NodesSnapshot;
+using NodesSnapshotPtr = std::shared_ptr<NodesSnapshot>;
+
+/**
+ * @brief A consistent copy of one attribute of all nodes of a trial.
+ *
+ * The trial (writer) publishes a copy of the attribute while it runs, and a
+ * single reader (e.g., a widget in the GUI thread) takes the most recent
+ * copy without locks. It is a triple buffer: the writer fills the back frame
+ * and swaps it with the middle one; the reader swaps the middle frame with
+ * the front one only when a newer frame is available. Thus, neither of them
+ * waits for the other, and the reader never sees a frame being written.
+ *
+ * @see Trial::subscribeNodes()
+ */
+class NodesSnapshot
+{
+public:
+    // minimum interval (ms) between two frames, i.e., ~60 frames per second
+    static const int PublishInterval = 16;
+
+    struct Frame {
+        int step = -1;             // -1 if nothing has been published yet
+        std::vector<Value> values; // indexed by node id
+        // The ids of the nodes whose value changed since the frame taken
+        // before this one by the reader (it might list a few more), unless
+        // 'allChanged' is true, e.g., in the first frame or when most of
+        // the values changed.
+        std::vector<int> changed;
+        bool allChanged = true;
+    };
+
+    // A 'stepInterval' > 0 makes the trial publish exactly the steps which
+    // are multiple of it (e.g., to record them), instead of the most recent
+    // step at most once every PublishInterval ms.
+    explicit NodesSnapshot(const int attrId, const int stepInterval = 0);
+
+    inline int attrId() const { return m_attrId; }
+    inline int stepInterval() const { return m_stepInterval; }
+
+    // Returns true if 'step' should be published, where 'timeout' is true
+    // if PublishInterval ms have passed since the last time-based frame.
+    // Writer only!
+    inline bool isDue(const int step, const bool timeout) const;
+
+    // Makes the most recent frame the front one.
+    // Returns true if a newer frame was taken.
+    // Reader only!
+    bool acquire();
+
+    // The frame taken in the last call to 'acquire()'.
+    // Reader only!
+    inline const Frame& front() const { return m_frames[m_front]; }
+
+    // Returns the value of the node in the front frame, or an invalid Value.
+    // Reader only!
+    inline const Value& value(const int nodeId) const;
+
+    // Copies the attribute of all nodes to the back frame and publishes it.
+    // Writer only!
+    void publish(const Nodes& nodes, const int step);
+
+private:
+    static const int FreshBit = 4;
+
+    const int m_attrId;
+    const int m_stepInterval;
+    Frame m_frames[3];
+    int m_back;                // writer only
+    int m_lastStep;            // writer only; the last step published
+    int m_prev;                // writer only; the last frame published, or -1
+    int m_front;               // reader only
+    std::atomic<int> m_middle; // index of the middle frame (| FreshBit if not read yet)
+    const Value m_invalid;
+
+    Q_DISABLE_COPY(NodesSnapshot)
+};
+
+inline bool NodesSnapshot::isDue(const int step, const bool timeout) const
+{
+    if (m_stepInterval > 0) {
+        return step % m_stepInterval == 0 && step != m_lastStep;
+    }
+    return timeout;
+}
+
+inline const Value& NodesSnapshot::value(const int nodeId) const
+{
+    const auto& values = m_frames[m_front].values;
+    return nodeId >= 0 && static_cast<size_t>(nodeId) < values.size()
+            ? values[static_cast<size_t>(nodeId)] : m_invalid;
+}
+
+} // evoplex
+#endif // SNAPSHOT_H
@@ -18,6 +18,7 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
@@ -25,6 +26,7 @@
 
 #include "abstractgraph.h"
 #include "abstractmodel.h"
+#include "framerecorder.h"
 #include "nodes_p.h"
 #include "trial.h"
 #include "project.h"
@@ -32,6 +34,12 @@
 
 namespace evoplex {
 
+namespace {
+// number of nodes hashed in each step by the models without an ActiveSet,
+// which is doubled whenever a candidate cycle turns out to be false
+const size_t kMinHashedNodes = 64;
+}
+
 Trial::Trial(const quint16 id, ExperimentPtr exp)
     : m_id(id),
       m_exp(exp),
@@ -39,7 +47,16 @@ Trial::Trial(const quint16 id, ExperimentPtr exp)
       m_status(Status::Disabled),
       m_prg(nullptr),
       m_graph(nullptr),
-      m_model(nullptr)
+      m_model(nullptr),
+      m_detectCycles(false),
+      m_hashEdges(false),
+      m_nodesHash(0),
+      m_hashedSteps(0),
+      m_cycleStep(-1),
+      m_cycleLength(0),
+      m_cycleConfirmed(false),
+      m_hasSnapshots(false),
+      m_hasStepSnapshots(false)
 {
     Q_ASSERT_X(exp, "Trial", "a trial must belong to a valid experiment");
     // important! Trials are deleted by the Experiment class,
@@ -49,6 +66,10 @@ Trial::Trial(const quint16 id, ExperimentPtr exp)
 
 Trial::~Trial()
 {
+    m_recorder.reset(); // it reads the graph until it's stopped
+    // the arenas are dropped with the graph, no need to recycle its objects
+    if (m_arena) { m_arena->stopRecycling(); }
+    if (m_edgesArena) { m_edgesArena->stopRecycling(); }
     delete m_graph;
     delete m_model;
     delete m_prg;
@@ -59,6 +80,11 @@ const QString& Trial::graphId() const
     return m_exp->graphPlugin()->id();
 }
 
+const ModelPlugin* Trial::modelPlugin() const
+{
+    return m_exp->modelPlugin();
+}
+
 GraphType Trial::graphType() const
 {
     return  m_exp->graphType();
@@ -70,11 +96,21 @@ bool Trial::init()
         return false;
     }
 
-    Nodes nodes = m_exp->cloneCachedNodes(m_id);
-    if (nodes.empty()) {
-        nodes = m_exp->createNodes();
+    // a rewound trial keeps its graph (see 'rewind()')
+    const bool rewinding = m_graph != nullptr;
+
+    Nodes nodes;
+    bool createdNodes = false;
+    if (!rewinding) {
+        m_arena = std::make_shared<Arena>();
+        m_edgesArena = std::make_shared<Arena>();
+        nodes = m_exp->cloneCachedNodes(m_id, m_arena);
         if (nodes.empty()) {
-            return false;
+            nodes = m_exp->createNodes();
+            if (nodes.empty()) {
+                return false;
+            }
+            createdNodes = true;
         }
     }
 
@@ -88,17 +124,44 @@ bool Trial::init()
     }
 
     const quint32 seed = m_exp->inputs()->general(GENERAL_ATTR_SEED).toUInt();
+    delete m_prg;
     m_prg = new PRG(seed + m_id);
 
-    m_graph = dynamic_cast<AbstractGraph*>(m_exp->graphPlugin()->create());
-    if (!m_graph || !m_graph->setup(*this, std::move(edgeAttrsGen),
-                                    *m_exp->inputs()->graph(), nodes)) {
-        qWarning() << "unable to create the trials."
-                   << "The graph could not be initialized."
-                   << "Experiment:" << m_exp->id();
-        return false;
+    if (rewinding) {
+        const bool restored = restoreNodes();
+        m_exp->releaseCachedNodes(m_id);
+        if (!restored) {
+            qWarning() << "unable to rewind the trials."
+                       << "The initial population is missing."
+                       << "Experiment:" << m_exp->id();
+            return false;
+        }
+        m_graph->m_edgeAttrsGen = std::move(edgeAttrsGen);
+    } else {
+        m_graph = dynamic_cast<AbstractGraph*>(m_exp->graphPlugin()->create());
+        if (!m_graph || !m_graph->setup(*this, std::move(edgeAttrsGen),
+                                        *m_exp->inputs()->graph(), nodes)) {
+            qWarning() << "unable to create the trials."
+                       << "The graph could not be initialized."
+                       << "Experiment:" << m_exp->id();
+            return false;
+        }
+    }
+
+    // the edges are rebuilt if they cannot be reused as they are, ie, if
+    // they are random or hold attributes that the model might have changed;
+    // as in a new graph, they must not exist when the model is initialized
+    const bool edgesWithAttrs = !m_graph->edges().empty() &&
+            !m_graph->edges().cbegin()->second.attrs()->isEmpty();
+    const bool resetGraph = !rewinding || m_graph->hasRandomTopology() ||
+                            m_graph->m_edgeAttrsGen || edgesWithAttrs;
+    if (rewinding && resetGraph) {
+        m_edgesArena->stopRecycling();
+        m_graph->resetEdges();
+        m_edgesArena = std::make_shared<Arena>();
     }
 
+    delete m_model;
     m_model = dynamic_cast<AbstractModel*>(m_exp->modelPlugin()->create());
     if (!m_model || !m_model->setup(*this, *m_exp->inputs()->model())) {
         qWarning() << "unable to create the trials."
@@ -107,40 +170,112 @@ bool Trial::init()
         return false;
     }
 
+    m_step = 0; // important!
+
     if (!m_exp->inputs()->fileCaches().empty()) {
-        const QString fpath = m_exp->m_filePathPrefix + QString("%4.csv").arg(m_id);
-        QFile file(fpath);
-        if (file.open(QFile::WriteOnly | QFile::Truncate)) {
-            QTextStream stream(&file);
-            stream << m_exp->m_fileHeader;
-            file.close();
-        } else {
-            qWarning() << "unable to create the trials. Could not write in " << fpath;
-            return false;
+        // when averaging the trials, the summary file is created by the experiment
+        if (!m_exp->m_aggregator) {
+            const QString fpath = m_exp->m_filePathPrefix + QString("%4.csv").arg(m_id);
+            QFile file(fpath);
+            if (file.open(QFile::WriteOnly | QFile::Truncate)) {
+                QTextStream stream(&file);
+                stream << m_exp->m_fileHeader;
+                file.close();
+            } else {
+                qWarning() << "unable to create the trials. Could not write in " << fpath;
+                return false;
+            }
         }
 
         // write this initial step to file
-        for (auto const& output : m_exp->m_outputs) {
-            output->doOperation(this);
+        if (m_exp->isOutputStep(0)) {
+            for (auto const& output : m_exp->m_outputs) {
+                output->doOperation(this);
+            }
+        }
+        if (m_exp->outputSaveSteps() == 0) {
+            writeCachedSteps(m_exp.get());
         }
-        writeCachedSteps(m_exp.get());
     }
 
     // make the set of nodes available for other trials
-    if (m_exp->numTrials() > 1 && m_exp->m_clonableNodes.empty()) {
+    if (createdNodes && m_exp->numTrials() > 1) {
         m_exp->m_clonableNodes = NodesPrivate::clone(nodes);
     }
 
-    m_step = 0; // important!
-
     // set-up the edges for the first time
-    if (!m_graph->reset()) {
+    if (resetGraph && !m_graph->reset()) {
         qWarning() << "unable to create the trials."
                    << "The graph could not be initialized."
                    << "Experiment:" << m_exp->id();
         return false;
     }
+    m_graph->m_topologyChanged = false;
+
+    if (!m_exp->outputFrames().isEmpty() && !startRecorder()) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Trial::startRecorder()
+{
+    m_recorder.reset(); // finishes saving the frames of the previous run
+
+    const QString prefix = QString("%1/%2_e%3_t%4")
+            .arg(m_exp->inputs()->general(OUTPUT_DIR).toQString(),
+                 m_exp->project()->name())
+            .arg(m_exp->id()).arg(m_id);
+    m_recorder.reset(new FrameRecorder(this,
+            modelPlugin()->nodeAttrRange(m_exp->outputFrames()),
+            m_exp->outputFramesInterval(), prefix));
+
+    // the squareGrid places the nodes in the cells of a grid
+    if (graphId() != "squareGrid") {
+        m_recorder->setLayout(FrameRecorder::Layout::Graph);
+    }
+
+    QString error;
+    if (!m_recorder->init(error)) {
+        qWarning() << "unable to create the trials." << error
+                   << "Experiment:" << m_exp->id();
+        m_recorder.reset();
+        return false;
+    }
+    m_recorder->start(QThread::LowPriority);
+    return true;
+}
 
+bool Trial::rewind()
+{
+    if (!m_graph || m_status == Status::Invalid || m_graph->m_topologyChanged) {
+        return false;
+    }
+
+    m_status = Status::Disabled;
+    m_step = -1;
+    resetCycleDetection();
+    return true;
+}
+
+bool Trial::restoreNodes()
+{
+    const Nodes& initial = m_exp->m_clonableNodes;
+    if (initial.size() != m_graph->nodes().size()) {
+        return false;
+    }
+    for (auto const& n : m_graph->nodes()) {
+        auto it = initial.find(n.first);
+        if (it == initial.cend()) {
+            return false;
+        }
+        Node node = n.second;
+        const Attributes& attrs = it->second.attrs();
+        for (int attrId = 0; attrId < attrs.size(); ++attrId) {
+            node.setAttr(attrId, attrs.value(attrId));
+        }
+    }
     return true;
 }
 
@@ -178,6 +313,7 @@ void Trial::run()
         } else {
             m_status = Status::Invalid;
         }
+        m_recorder.reset(); // waits for the last frames to be saved
     } else {
         m_status = Status::Paused;
     }
@@ -193,26 +329,70 @@ bool Trial::runSteps()
     t.start();
 
     m_model->beforeLoop();
+    publishSnapshots(true);
+
+    // the nodes might have been edited while paused (e.g., in the GUI),
+    // so the first step after resuming must visit all of them
+    if (m_model->m_activeSet) {
+        m_model->m_activeSet->activateAll();
+    }
+
+    // the nodes might have been edited while paused (e.g., in the GUI),
+    // so the detection starts over from the current state
+    resetCycleDetection();
+    m_detectCycles = exp->steadyState() > 0;
+    if (m_detectCycles) {
+        detectCycle(hashState(true), exp->steadyState());
+    }
 
     bool hasNext = true;
     while (m_step < exp->pauseAt() && hasNext) {
-        hasNext = m_model->algorithmStep();
+        // once in a steady state, the model does not need to be stepped anymore
+        const bool replay = isReplayingCycle();
+        if (!replay) {
+            if (m_model->m_activeSet) {
+                m_model->m_activeSet->advance(m_graph->nodes());
+            }
+            const unsigned long long draws = m_prg->draws();
+            hasNext = m_model->algorithmStep();
+            // a stochastic model might leave a state it has visited before
+            if (m_detectCycles && m_prg->draws() != draws) {
+                m_detectCycles = false;
+                resetCycleDetection();
+            }
+        }
         ++m_step;
 
-        for (const OutputPtr& output : exp->m_outputs) {
-            output->doOperation(this);
+        if (exp->isOutputStep(m_step)) {
+            doOutputs();
         }
 
-        if (m_step % exp->m_mainApp->stepsToFlush() == 0 && !writeCachedSteps(exp)) {
+        // when saving only the last n steps, the rows are kept in a rolling
+        // buffer and written to file once the trial is finished
+        if (exp->outputSaveSteps() == 0 &&
+                m_step % exp->m_mainApp->stepsToFlush() == 0 && !writeCachedSteps(exp)) {
             m_status = Status::Invalid;
             return false;
         }
 
+        if (m_detectCycles && hasNext && !replay) {
+            const quint64 hash = hashState(false);
+            if (detectCycle(hash, exp->steadyState()) && !exp->steadyStatePad()) {
+                hasNext = false;
+            }
+        }
+
+        publishSnapshots(false);
+
         if (exp->delay() > 0) {
             QThread::msleep(exp->delay());
         }
     }
 
+    // make sure the nodes reflect the current step
+    syncCycleState();
+    publishSnapshots(true);
+
     m_model->afterLoop();
 
     qDebug() << QString("[E%1:T%2] %3s").arg(exp->id())
@@ -221,6 +401,52 @@ bool Trial::runSteps()
     return hasNext;
 }
 
+NodesSnapshotPtr Trial::subscribeNodes(const int attrId, const int stepInterval) const
+{
+    auto snapshot = std::make_shared<NodesSnapshot>(attrId, stepInterval);
+    QMutexLocker locker(&m_snapshotsMutex);
+    m_snapshots.emplace_back(snapshot);
+    if (stepInterval > 0) {
+        m_hasStepSnapshots.store(true, std::memory_order_release);
+    }
+    m_hasSnapshots.store(true, std::memory_order_release);
+    return snapshot;
+}
+
+void Trial::publishSnapshots(const bool force)
+{
+    // cheap check for the common case, ie, nobody is watching
+    if (!m_hasSnapshots.load(std::memory_order_acquire) || !m_graph) {
+        return;
+    }
+    const bool timeout = force || !m_lastPublished.isValid() ||
+            m_lastPublished.elapsed() >= NodesSnapshot::PublishInterval;
+    if (!timeout && !m_hasStepSnapshots.load(std::memory_order_acquire)) {
+        return;
+    }
+    if (timeout) {
+        m_lastPublished.start();
+    }
+
+    QMutexLocker locker(&m_snapshotsMutex);
+    bool hasStepSnapshots = false;
+    auto it = m_snapshots.begin();
+    while (it != m_snapshots.end()) {
+        NodesSnapshotPtr snapshot = it->lock();
+        if (snapshot) {
+            if (snapshot->isDue(m_step, timeout)) {
+                snapshot->publish(m_graph->nodes(), m_step);
+            }
+            hasStepSnapshots |= snapshot->stepInterval() > 0;
+            ++it;
+        } else {
+            it = m_snapshots.erase(it);
+        }
+    }
+    m_hasStepSnapshots.store(hasStepSnapshots, std::memory_order_release);
+    m_hasSnapshots.store(!m_snapshots.empty(), std::memory_order_release);
+}
+
 bool Trial::writeCachedSteps(const Experiment* exp) const
 {
     if (exp->inputs()->fileCaches().empty() ||
@@ -228,6 +454,20 @@ bool Trial::writeCachedSteps(const Experiment* exp) const
         return true;
     }
 
+    if (exp->m_aggregator) {
+        do {
+            const int step = exp->inputs()->fileCaches().front()->readFrontRow(m_id).first;
+            Values row;
+            for (Cache* cache : exp->inputs()->fileCaches()) {
+                const Values& vals = cache->readFrontRow(m_id).second;
+                row.insert(row.end(), vals.begin(), vals.end());
+                cache->flushFrontRow(m_id);
+            }
+            exp->m_aggregator->addRow(step, row);
+        } while (!exp->inputs()->fileCaches().front()->isEmpty(m_id));
+        return exp->m_aggregator->writeRows(false);
+    }
+
     const QString fpath = exp->m_filePathPrefix + QString("%1.csv").arg(m_id);
     QFile file(fpath);
     if (!file.open(QFile::WriteOnly | QFile::Append)) {
@@ -256,4 +496,249 @@ bool Trial::writeCachedSteps(const Experiment* exp) const
     return true;
 }
 
+void Trial::resetCycleDetection()
+{
+    m_nodeHashes.clear();
+    m_hashedNodes.clear();
+    m_nodesHash = 0;
+    m_stateHashes.clear();
+    m_hashedStates.clear();
+    m_hashedSteps = 0;
+    m_cycleStep = -1;
+    m_cycleLength = 0;
+    m_cycleConfirmed = false;
+    m_cycleState.clear();
+    m_cycleRows.clear();
+}
+
+quint64 Trial::hashState(const bool full)
+{
+    auto nodeHash = [](const Node& node) {
+        quint64 h = Utils::mix64(static_cast<quint64>(node.id()));
+        for (const Value& v : node.attrs().values()) {
+            h = Utils::mix64(h ^ std::hash<Value>()(v));
+        }
+        return h;
+    };
+
+    // the nodes are visited in an arbitrary order, so the hashes of the
+    // nodes are combined with a commutative operation (sum)
+    if (!m_model->m_activeSet) {
+        // a matching sample is confirmed against the whole state anyway
+        if (full || m_hashedNodes.empty()) {
+            sampleHashedNodes(kMinHashedNodes);
+        }
+        m_nodesHash = 0;
+        for (const Node& node : m_hashedNodes) {
+            m_nodesHash += nodeHash(node);
+        }
+    } else if (full) {
+        m_nodesHash = 0;
+        for (auto const& n : m_graph->nodes()) {
+            const size_t id = static_cast<size_t>(n.first);
+            if (id >= m_nodeHashes.size()) {
+                m_nodeHashes.resize(id + 1, 0);
+            }
+            m_nodeHashes[id] = nodeHash(n.second);
+            m_nodesHash += m_nodeHashes[id];
+        }
+    } else {
+        // only the nodes which changed in the last step
+        for (const Node& node : m_model->m_activeSet->dirtyNodes()) {
+            const size_t id = static_cast<size_t>(node.id());
+            if (id >= m_nodeHashes.size()) {
+                m_nodeHashes.resize(id + 1, 0);
+            }
+            quint64& h = m_nodeHashes[id];
+            m_nodesHash -= h;
+            h = nodeHash(node);
+            m_nodesHash += h;
+        }
+    }
+
+    if (full) {
+        const Edges& edges = m_graph->edges();
+        m_hashEdges = !edges.empty() && edges.cbegin()->second.attrs() &&
+                      !edges.cbegin()->second.attrs()->isEmpty();
+    }
+    quint64 hash = m_nodesHash;
+    if (m_hashEdges) {
+        // the edges are not tracked by the ActiveSet
+        for (auto const& e : m_graph->edges()) {
+            quint64 h = Utils::mix64(~static_cast<quint64>(e.first));
+            for (const Value& v : e.second.attrs()->values()) {
+                h = Utils::mix64(h ^ std::hash<Value>()(v));
+            }
+            hash += h;
+        }
+    }
+    return hash;
+}
+
+void Trial::sampleHashedNodes(const size_t size)
+{
+    const Nodes& nodes = m_graph->nodes();
+    const size_t stride = std::max<size_t>(1, nodes.size() / std::max<size_t>(1, size));
+    m_hashedNodes.clear();
+    m_hashedNodes.reserve(nodes.size() / stride + 1);
+    size_t i = 0;
+    for (auto const& n : nodes) {
+        if (i++ % stride == 0) {
+            m_hashedNodes.emplace_back(n.second);
+        }
+    }
+}
+
+bool Trial::detectCycle(const quint64 hash, const int maxLength)
+{
+    bool confirmed = false;
+
+    if (m_cycleLength > 0) {
+        if (m_hashedSteps - m_cycleStep < m_cycleLength) {
+            // still going through the candidate cycle
+            if (m_exp->steadyStatePad()) {
+                m_cycleRows.emplace_back();
+            }
+        } else if (hash == m_stateHashes[m_cycleStep % maxLength] &&
+                   isState(m_cycleState)) {
+            confirmed = true;
+        } else if (!m_model->m_activeSet &&
+                   m_hashedNodes.size() < m_graph->nodes().size()) {
+            // the sample of nodes is not enough to tell the states apart;
+            // let's hash more nodes and start over
+            const size_t size = m_hashedNodes.size() * 2;
+            resetCycleDetection();
+            sampleHashedNodes(size);
+            return false;
+        } else {
+            // it was a hash collision
+            m_cycleStep = -1;
+            m_cycleLength = 0;
+            m_cycleState.clear();
+            m_cycleRows.clear();
+        }
+    }
+
+    if (m_cycleLength == 0) {
+        // the ring keeps the last 'maxLength' states, so the latest state
+        // with the same hash closes the shortest cycle within the limit
+        auto it = m_hashedStates.find(hash);
+        if (it != m_hashedStates.end()) {
+            m_cycleStep = m_hashedSteps;
+            m_cycleLength = m_hashedSteps - it->second;
+            m_cycleState = state();
+            if (m_exp->steadyStatePad()) {
+                m_cycleRows.emplace_back();
+            }
+        }
+    }
+
+    if (!m_cycleRows.empty() && m_cycleRows.back().empty()) {
+        // the values of the outputs in the current step of the cycle
+        for (const OutputPtr& output : m_exp->m_outputs) {
+            const bool hasTrial = output->trialIds().count(m_id) > 0;
+            m_cycleRows.back().emplace_back(hasTrial ? output->allValues(this) : Values());
+        }
+    }
+
+    if (m_stateHashes.size() != static_cast<size_t>(maxLength)) {
+        m_stateHashes.assign(static_cast<size_t>(maxLength), 0);
+    }
+    quint64& oldest = m_stateHashes[m_hashedSteps % maxLength];
+    if (m_hashedSteps >= maxLength) {
+        auto it = m_hashedStates.find(oldest);
+        if (it != m_hashedStates.end() && it->second == m_hashedSteps - maxLength) {
+            m_hashedStates.erase(it);
+        }
+    }
+    oldest = hash;
+    m_hashedStates[hash] = m_hashedSteps;
+    ++m_hashedSteps;
+
+    if (confirmed) {
+        // 'm_cycleStep' was counted in hashed states; make it a trial step
+        m_cycleStep = m_step - m_cycleLength;
+        m_cycleConfirmed = true;
+        m_cycleState.clear();
+    }
+    return confirmed;
+}
+
+void Trial::doOutputs()
+{
+    if (!m_cycleConfirmed || m_cycleRows.empty()) {
+        for (const OutputPtr& output : m_exp->m_outputs) {
+            output->doOperation(this);
+        }
+        return;
+    }
+
+    // the model is not stepped anymore; the outputs take the values of the
+    // cycle (in the same order as they were taken, as the outputs did not change)
+    const auto& rows = m_cycleRows.at(static_cast<size_t>((m_step - m_cycleStep) % m_cycleLength));
+    Q_ASSERT(rows.size() == m_exp->m_outputs.size());
+    auto row = rows.cbegin();
+    for (const OutputPtr& output : m_exp->m_outputs) {
+        output->doOperation(this, *row++);
+    }
+}
+
+void Trial::syncCycleState()
+{
+    if (!m_cycleConfirmed) {
+        return;
+    }
+    const int phase = (m_step - m_cycleStep) % m_cycleLength;
+    for (int i = 0; i < phase; ++i) {
+        if (m_model->m_activeSet) {
+            m_model->m_activeSet->advance(m_graph->nodes());
+        }
+        m_model->algorithmStep();
+    }
+    // the current step starts the cycle now
+    if (!m_cycleRows.empty()) {
+        std::rotate(m_cycleRows.begin(), m_cycleRows.begin() + phase, m_cycleRows.end());
+    }
+    m_cycleStep = m_step;
+}
+
+Values Trial::state() const
+{
+    Values state;
+    for (auto const& n : m_graph->nodes()) {
+        const Values& attrs = n.second.attrs().values();
+        state.insert(state.end(), attrs.begin(), attrs.end());
+    }
+    if (m_hashEdges) {
+        for (auto const& e : m_graph->edges()) {
+            const Values& attrs = e.second.attrs()->values();
+            state.insert(state.end(), attrs.begin(), attrs.end());
+        }
+    }
+    return state;
+}
+
+bool Trial::isState(const Values& state) const
+{
+    // the nodes and edges are visited in the same order as in 'state()'
+    auto it = state.cbegin();
+    for (auto const& n : m_graph->nodes()) {
+        for (const Value& v : n.second.attrs().values()) {
+            if (it == state.cend() || *it++ != v) {
+                return false;
+            }
+        }
+    }
+    if (m_hashEdges) {
+        for (auto const& e : m_graph->edges()) {
+            for (const Value& v : e.second.attrs()->values()) {
+                if (it == state.cend() || *it++ != v) {
+                    return false;
+                }
+            }
+        }
+    }
+    return it == state.cend();
+}
+
 } // evoplex
@@ -21,14 +21,23 @@
 #ifndef TRIAL_H
 #define TRIAL_H
 
+#include <atomic>
+#include <memory>
 #include <unordered_map>
+#include <vector>
+#include <QElapsedTimer>
+#include <QMutex>
 #include <QRunnable>
 
+#include "arena.h"
 #include "enum.h"
 #include "experiment.h"
+#include "snapshot.h"
 
 namespace evoplex {
 
+class FrameRecorder;
+
 /**
  * A trial is part of an experiment which might have several other trials.
  * All trials of an experiment have exactly the same initial conditions,
@@ -54,6 +63,7 @@ public:
 
     const QString& graphId() const;
     GraphType graphType() const;
+    const ModelPlugin* modelPlugin() const;
 
     inline quint16 id() const;
     inline Status status() const;
@@ -64,6 +74,14 @@ public:
     inline const AbstractModel* model() const;
     inline AbstractGraph* graph() const;
 
+    // Creates a snapshot of the node attribute 'attrId', which is published
+    // by this trial while it runs, at most once every PublishInterval ms;
+    // or every 'stepInterval' steps if it's > 0 (see NodesSnapshot).
+    // It lets other threads (eg, the GUI) read the attribute without racing
+    // with the model. The trial stops publishing when the caller drops it.
+    // This method is thread-safe.
+    NodesSnapshotPtr subscribeNodes(const int attrId, const int stepInterval = 0) const;
+
 private:
     const quint16 m_id;
     ExperimentPtr m_exp;
@@ -74,17 +92,106 @@ private:
     AbstractGraph* m_graph;
     AbstractModel* m_model;
 
+    // the nodes and edges of this trial are allocated in the arenas,
+    // which are released at once when the trial and its nodes are gone
+    ArenaPtr m_arena;      // nodes
+    ArenaPtr m_edgesArena; // edges, replaced when the edges are rebuilt
+
+    // steady-state detection (see GENERAL_ATTR_STEADYSTATE)
+    // It assumes that the next state depends only on the attributes of the
+    // nodes and edges, so it's turned off once the model draws from the PRG.
+    // Once a cycle is confirmed, the model is not stepped anymore: the outputs
+    // are padded with the values of the cycle, and the nodes are only brought
+    // to the current step when the trial pauses or finishes.
+    bool m_detectCycles;                // false if disabled in this run
+    bool m_hashEdges;                   // true if the edges have attributes
+    std::vector<quint64> m_nodeHashes;  // hash of each node, indexed by id
+    std::vector<Node> m_hashedNodes;    // nodes hashed in each step if there's no ActiveSet
+    quint64 m_nodesHash;                // sum of the hashes of the nodes
+    std::vector<quint64> m_stateHashes; // ring buffer with the hashes of the last states
+    std::unordered_map<quint64, int> m_hashedStates; // <hash, last state in the ring with it>
+    int m_hashedSteps;                  // number of states hashed so far
+    int m_cycleStep;                    // step in which the (candidate) cycle starts
+    int m_cycleLength;                  // 0 if no cycle has been found yet
+    bool m_cycleConfirmed;              // false while the candidate cycle is checked
+    Values m_cycleState;                // state in which the candidate cycle starts
+    std::vector<std::vector<Values>> m_cycleRows; // values of each output in each step of the cycle
+
+    // snapshots of the nodes requested by other threads (see subscribeNodes())
+    mutable QMutex m_snapshotsMutex;
+    mutable std::vector<std::weak_ptr<NodesSnapshot>> m_snapshots;
+    mutable std::atomic<bool> m_hasSnapshots;
+    mutable std::atomic<bool> m_hasStepSnapshots; // any with a step interval
+    QElapsedTimer m_lastPublished;
+
+    // saves the nodes as images while it runs (see OUTPUT_FRAMES)
+    std::unique_ptr<FrameRecorder> m_recorder;
+
     // We can safely consider that all parameters are valid at this point.
     // However, some things might fail (eg, missing nodes, broken graph etc),
     // and, in that case, false is returned.
     bool init();
 
+    // Prepares the trial to start over, keeping the graph (see Experiment::reset).
+    // Then, 'init()' only restores the nodes' attributes and the PRG, and
+    // re-creates the model; the graph's 'reset()' is called again only if the
+    // topology depends on randomness or if the edges have attributes.
+    // Returns false if the graph cannot be reused, e.g., when the model
+    // added or removed nodes or edges; such trial must be created again.
+    bool rewind();
+
+    // Copies the nodes' attributes of the initial population into the graph.
+    bool restoreNodes();
+
+    // Creates and starts the recorder of the nodes, replacing the previous one.
+    // It must be called once the graph is set, before the trial runs.
+    bool startRecorder();
+
     // The main loop for calling the model steps
     // Returns true if it has a next step
     bool runSteps();
 
-    // If any file output is set, it'll write the cached steps to file.
+    // If any file output is set, it will write the cached steps to file or,
+    // when averaging the trials, merge them into the experiment summary.
     bool writeCachedSteps(const Experiment* exp) const;
+
+    // Clears the hashes and cycles found so far.
+    void resetCycleDetection();
+
+    // Returns the hash of the current state. Unless 'full' is true, the hash
+    // of a node is only updated if it was marked dirty in the model's
+    // ActiveSet. Without an ActiveSet, any node might have changed, so only
+    // a sample of the nodes is hashed (see 'sampleHashedNodes()').
+    quint64 hashState(const bool full);
+
+    // Picks about 'size' nodes, evenly spread, to be hashed in each step.
+    void sampleHashedNodes(const size_t size);
+
+    // Looks for a cycle of length up to 'maxLength' closed by the current state.
+    // A matching hash is just a candidate: the state is stored, and the cycle
+    // is confirmed once the trial gets back to this exact state. Meanwhile,
+    // the values of the outputs in each step of the cycle are kept to pad them.
+    // Returns true if a cycle has been confirmed in this step.
+    bool detectCycle(const quint64 hash, const int maxLength);
+
+    // true if the outputs are being padded by replaying the detected cycle
+    inline bool isReplayingCycle() const;
+
+    // Evaluates the outputs in the current step; or, when replaying a cycle,
+    // caches the values they had in the corresponding step of the cycle.
+    void doOutputs();
+
+    // Steps the model through the replayed cycle (less than a cycle) until
+    // the nodes are in the state of the current step.
+    void syncCycleState();
+
+    // Publishes the current state of the nodes to the subscribed snapshots.
+    // Unless 'force' is true, it does nothing if the last one is too recent.
+    void publishSnapshots(const bool force);
+
+    // the attributes of all nodes (and edges, if hashed) in the current step
+    Values state() const;
+    bool isState(const Values& state) const;
 };
 
 /************************************************************************
@@ -112,5 +219,8 @@ inline const AbstractModel* Trial::model() const
 inline AbstractGraph* Trial::graph() const
 { return m_graph; }
 
+inline bool Trial::isReplayingCycle() const
+{ return m_cycleConfirmed; }
+
 } // evoplex
 #endif // TRIAL_H
@@ -24,7 +24,7 @@
 #include <QWidget>
 
 #include "core/include/attributerange.h"
-#include "colormap.h"
+#include "core/colormap.h"
 
 class Ui_AttrColorSelector;
 
@@ -38,6 +38,7 @@ BaseGraphGL::BaseGraphGL(ExperimentPtr exp, GraphWidget* parent)
       m_currStep(-1),
       m_nodeAttr(-1),
       m_nodeCMap(nullptr),
+      m_valuesVersion(0),
       m_background(QColor(239,235,231)),
       m_zoomLevel(0.f),
       m_nodeScale(10.),
@@ -45,7 +46,12 @@ BaseGraphGL::BaseGraphGL(ExperimentPtr exp, GraphWidget* parent)
       m_origin(m_nodeScale, m_nodeScale),
       m_cacheStatus(CacheStatus::Ready),
       m_posEntered(0,0),
-      m_currTrialId(0)
+      m_currTrialId(0),
+      m_nodesIndexDirty(true),
+      m_nodesIndexVersion(0),
+      m_cacheOutdated(true),
+      m_acquiredVersion(~0u),
+      m_changedNodesKnown(false)
 {
     m_ui->setupUi(this);
 
@@ -102,6 +108,7 @@ BaseGraphGL::~BaseGraphGL()
 {
     m_exp->disconnect(this); // important to avoid triggering statusChanged()
     m_attrWidgets.clear();
+    m_nodesSnapshot.reset();
     m_trial = nullptr;
     m_exp = nullptr;
     delete m_ui;
@@ -118,6 +125,13 @@ void BaseGraphGL::paint(QPaintDevice* device, bool paintBackground) const
 
     painter.translate(m_origin);
     if (m_cacheStatus == CacheStatus::Ready) {
+        if (m_nodesSnapshot && m_nodesSnapshot->acquire()) { // takes the latest frame, if any
+            // the changes are relative to the previous frame, so they are
+            // only known if nothing else has changed the values since then
+            m_changedNodesKnown = m_acquiredVersion == m_valuesVersion &&
+                                  !m_nodesSnapshot->front().allChanged;
+            m_acquiredVersion = ++m_valuesVersion;
+        }
         paintFrame(painter);
     }
     painter.end();
@@ -232,6 +246,18 @@ void BaseGraphGL::updateCache(bool force)
     m_mutex.unlock();
 }
 
+bool BaseGraphGL::updateNodesIndex(const AbstractGraph* graph)
+{
+    bool outdated = m_cacheOutdated.exchange(false);
+    const quint64 version = graph->nodesVersion();
+    if (m_nodesIndexDirty.exchange(false) || m_nodesIndexVersion != version) {
+        m_nodesIndexVersion = version;
+        m_nodesIndex.build(graph->nodes());
+        outdated = true;
+    }
+    return outdated;
+}
+
 void BaseGraphGL::slotStatusChanged(Status s)
 {
     for (auto aw : m_attrWidgets) {
@@ -239,10 +265,12 @@ void BaseGraphGL::slotStatusChanged(Status s)
             aw->setReadOnly(s == Status::Running);
         }
     }
+    ++m_valuesVersion; // nodeValue() reads the snapshots only while running
 }
 
 void BaseGraphGL::slotRestarted()
 {
+    releaseTrial();
     if (m_exp->autoDeleteTrials()) {
         m_graphWidget->close();
         return;
@@ -250,6 +278,9 @@ void BaseGraphGL::slotRestarted()
     clearSelection();
     setupInspector();
     m_trial = nullptr;
+    m_nodesSnapshot.reset();
+    m_nodesIndexDirty = true;
+    ++m_valuesVersion;
     m_ui->currStep->setText("--");
     updateCache(true);
 }
@@ -258,13 +289,19 @@ void BaseGraphGL::setNodeCMap(ColorMap* cmap)
 {
     m_nodeCMap = cmap;
     m_nodeAttr = cmap ? cmap->attrRange()->id() : -1;
+    subscribeNodes();
+    ++m_valuesVersion;
     update();
 }
 
 void BaseGraphGL::setTrial(quint16 trialId)
 {
+    releaseTrial();
     m_currTrialId = trialId;
     m_trial = m_exp->trial(trialId);
+    m_nodesIndexDirty = true;
+    subscribeNodes();
+    ++m_valuesVersion;
     if (m_trial && m_trial->model()) {
         m_ui->currStep->setText(QString::number(m_trial->step()));
     } else {
@@ -273,6 +310,44 @@ void BaseGraphGL::setTrial(quint16 trialId)
     updateCache();
 }
 
+const Value& BaseGraphGL::nodeValue(const Node& node) const
+{
+    if (m_nodesSnapshot && m_trial && m_trial->status() == Status::Running) {
+        const Value& v = m_nodesSnapshot->value(node.id());
+        if (v.isValid()) {
+            return v;
+        }
+    }
+    return node.attr(m_nodeAttr);
+}
+
+const Value& BaseGraphGL::nodeValue(const int nodeId) const
+{
+    if (m_nodesSnapshot && m_trial && m_trial->status() == Status::Running) {
+        const Value& v = m_nodesSnapshot->value(nodeId);
+        if (v.isValid()) {
+            return v;
+        }
+    }
+    if (m_trial && m_trial->graph()) {
+        const Nodes& nodes = m_trial->graph()->nodes();
+        const auto it = nodes.find(nodeId);
+        if (it != nodes.cend()) {
+            return it->second.attr(m_nodeAttr);
+        }
+    }
+    return m_invalidValue;
+}
+
+void BaseGraphGL::subscribeNodes()
+{
+    if (m_trial && m_nodeAttr >= 0) {
+        m_nodesSnapshot = m_trial->subscribeNodes(m_nodeAttr);
+    } else {
+        m_nodesSnapshot.reset();
+    }
+}
+
 void BaseGraphGL::setNodeScale(int v)
 {
     m_nodeScale = v;
@@ -458,6 +533,8 @@ void BaseGraphGL::updateView(bool forceUpdate)
     }
     m_currStep = m_trial->step();
     m_ui->currStep->setText(QString::number(m_currStep));
+    stepChanged();
+    ++m_valuesVersion;
     update();
 }
 
@@ -21,7 +21,9 @@
 #ifndef BASEGRAPHGL_H
 #define BASEGRAPHGL_H
 
+#include <atomic>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 #include <QOpenGLWidget>
@@ -30,12 +32,15 @@
 #include <QPainter>
 #include <QTimer>
 
+#include "core/include/abstractgraph.h"
+#include "core/colormap.h"
 #include "core/experiment.h"
+#include "core/snapshot.h"
 
-#include "colormap.h"
 #include "experimentwidget.h"
 #include "graphwidget.h"
 #include "maingui.h"
+#include "spatialindex.h"
 
 class Ui_BaseGraphGL;
 
@@ -83,6 +88,10 @@ protected:
     int m_currStep;
     int m_nodeAttr;
     ColorMap* m_nodeCMap;
+    NodesSnapshotPtr m_nodesSnapshot; // m_nodeAttr published by the trial
+    // changes whenever the values of m_nodeAttr might have changed, i.e.,
+    // images of the values can be reused while it is the same
+    mutable quint32 m_valuesVersion;
 
     QBrush m_background;
     float m_zoomLevel;
@@ -92,12 +101,60 @@ protected:
 
     CacheStatus m_cacheStatus;
 
+    // Index of the nodes' coordinates of the current trial, used for the
+    // viewport queries and picking. It's only read while the cache is Ready.
+    SpatialIndex m_nodesIndex;
+
     CacheStatus refreshCache() override { return CacheStatus::Ready; }
 
     void clearSelection() override;
 
     void updateCache(bool force=false);
 
+    // Called right before the view moves to another trial or the trial is
+    // restarted, e.g., to stop the background jobs using its nodes.
+    virtual void releaseTrial() {}
+
+    // Called in 'updateView()' when the trial has moved to another step.
+    // The cached geometry depends on the nodes' coordinates only, thus it is
+    // kept by default; views caching the edges must check them here.
+    virtual void stepChanged() {}
+
+    // Rebuilds the index if the trial has changed or nodes were added or
+    // removed (see AbstractGraph::nodesVersion()).
+    // Returns true if the geometry cached by the view is outdated, i.e., if
+    // the index was rebuilt or 'invalidateCache()' was called since then.
+    // It's meant to be called from 'refreshCache()'.
+    bool updateNodesIndex(const AbstractGraph* graph);
+
+    // the cached geometry will be rebuilt in the next 'refreshCache()'
+    inline void invalidateCache() { m_cacheOutdated = true; }
+
+    // the index will be rebuilt in the next 'refreshCache()', e.g., after
+    // changing the nodes' coordinates
+    inline void invalidateNodesIndex() { m_nodesIndexDirty = true; }
+
+    // The value of the node attribute being visualised (m_nodeAttr).
+    // While the trial runs, it's read from the last snapshot published by
+    // the trial, so we never race with (or wait for) the model.
+    const Value& nodeValue(const Node& node) const;
+
+    // The same as above, but the node is looked up by its id if the trial is
+    // not running. Returns an invalid Value if there is no such node.
+    const Value& nodeValue(const int nodeId) const;
+
+    // The ids of the nodes whose values changed in the last snapshot taken,
+    // i.e., from m_valuesVersion - 1 to m_valuesVersion (it might list a few
+    // more). Returns nullptr if they are unknown, e.g., if the values might
+    // have changed for another reason (a new colormap, trial or status).
+    inline const std::vector<int>* changedNodes() const;
+
+    // The colour of a value in m_nodeCMap, or transparent if it has none.
+    // The views colour the nodes as they draw them (a lookup table), so only
+    // the visible ones are coloured.
+    inline QRgb valueRgb(const Value& value) const;
+    inline QRgb nodeRgb(const Node& node) const { return valueRgb(nodeValue(node)); }
+
     inline void paintEvent(QPaintEvent*) override;
     void mousePressEvent(QMouseEvent* e) override;
     void mouseReleaseEvent(QMouseEvent* e) override;
@@ -132,6 +189,12 @@ private:
     quint16 m_currTrialId;
     QMutex m_mutex;
     QRect m_inspGeo; // inspector geometry with margin
+    std::atomic<bool> m_nodesIndexDirty;
+    quint64 m_nodesIndexVersion; // the graph's nodesVersion() of 'm_nodesIndex'
+    std::atomic<bool> m_cacheOutdated;
+    mutable quint32 m_acquiredVersion; // m_valuesVersion when the last snapshot was taken
+    mutable bool m_changedNodesKnown;  // see changedNodes()
+    const Value m_invalidValue;
     std::vector<std::shared_ptr<AttrWidget>> m_attrWidgets;
 
     void attrChanged(int attrId) const;
@@ -139,10 +202,30 @@ private:
     void setupInspector();
 
     void updateInspector(const Node& node);
+
+    void subscribeNodes();
 };
 
 inline void BaseGraphGL::paintEvent(QPaintEvent*)
 { paint(this, true); }
 
+inline const std::vector<int>* BaseGraphGL::changedNodes() const
+{
+    return m_nodesSnapshot && m_changedNodesKnown && m_acquiredVersion == m_valuesVersion
+            ? &m_nodesSnapshot->front().changed : nullptr;
+}
+
+inline QRgb BaseGraphGL::valueRgb(const Value& value) const
+{
+    if (!value.isValid()) {
+        return 0;
+    }
+    try {
+        return m_nodeCMap->rgb(value);
+    } catch (std::out_of_range) {
+        return 0; // leave it transparent
+    }
+}
+
 } // evoplex
 #endif // BASEGRAPHGL_H
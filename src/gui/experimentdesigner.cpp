@@ -123,6 +123,16 @@ ExperimentDesigner::ExperimentDesigner(MainApp* mainApp, QWidget *parent)
     addGeneralAttr(m_treeItemGeneral, GENERAL_ATTR_TRIALS);
     // --  auto delete
     addGeneralAttr(m_treeItemGeneral, GENERAL_ATTR_AUTODELETE);
+    // --  steady state
+    AttrWidget* steadyState = addGeneralAttr(m_treeItemGeneral, GENERAL_ATTR_STEADYSTATE);
+    steadyState->setToolTip("finishes a trial when its nodes reach a cycle of\n"
+                            "length <=n (1 for fixed points, up to 1000);\n"
+                            "0 to disable\n"
+                            "(ignored by models which use random numbers)");
+    steadyState->setValue(0);
+    addGeneralAttr(m_treeItemGeneral, GENERAL_ATTR_STEADYPAD)->setToolTip(
+                "keep saving the outputs until 'stopAt' once a steady state is reached\n"
+                "(the values of the cycle are repeated; the model is not stepped)");
 
     // setup the tree widget: outputs
     m_treeItemOutputs = new QTreeWidgetItem(m_ui->treeWidget);
@@ -142,34 +152,46 @@ ExperimentDesigner::ExperimentDesigner(MainApp* mainApp, QWidget *parent)
     connect(outHeader->button(), SIGNAL(pressed()), SLOT(slotOutputWidget()));
     addGeneralAttr(m_treeItemOutputs, OUTPUT_HEADER, outHeader);
 
-/* TODO: make the buttons to avgTrials and saveSteps work*/
-/*    // -- avgTrials
-    QtMaterialCheckBox* outAvgTrials = new QtMaterialCheckBox("average trials");
-    addGeneralAttr(m_treeItemOutputs, OUTPUT_AVGTRIALS, QVariant::fromValue(outAvgTrials));
-    // -- steps to save
-    QRadioButton* outAllSteps = new QRadioButton("all");
-    outAllSteps->setChecked(true);
-    QRadioButton* outLastSteps = new QRadioButton("last");
-    QSpinBox* outNumSteps = new QSpinBox();
-    outNumSteps->setButtonSymbols(QSpinBox::NoButtons);
-    outNumSteps->setMinimum(0);
-    outNumSteps->setMaximum(EVOPLEX_MAX_STEPS);
-    QHBoxLayout* outStepsLayout = new QHBoxLayout(new QWidget(m_ui->treeWidget));
-    outStepsLayout->setMargin(0);
-    outStepsLayout->insertWidget(0, outAllSteps);
-    outStepsLayout->insertWidget(1, outLastSteps);
-    outStepsLayout->insertWidget(2, outNumSteps);
-    outStepsLayout->insertSpacerItem(3, new QSpacerItem(5,5,QSizePolicy::MinimumExpanding));
-    QTreeWidgetItem* itemOut = new QTreeWidgetItem(m_treeItemOutputs);
-    itemOut->setText(0, OUTPUT_SAVESTEPS);
-    m_ui->treeWidget->setItemWidget(itemOut, 1, outStepsLayout->parentWidget());
-*/
+    // -- output schedule
+    AttrWidget* outStartAt = addGeneralAttr(m_treeItemOutputs, OUTPUT_STARTAT);
+    outStartAt->setToolTip("first step to be saved");
+    outStartAt->setValue(0);
+    AttrWidget* outInterval = addGeneralAttr(m_treeItemOutputs, OUTPUT_INTERVAL);
+    outInterval->setToolTip("save every n steps");
+    outInterval->setValue(1);
+    AttrWidget* outSaveSteps = addGeneralAttr(m_treeItemOutputs, OUTPUT_SAVESTEPS);
+    outSaveSteps->setToolTip("0 to save all steps; n>0 to save the last n steps");
+    outSaveSteps->setValue(0);
+
+    // -- avgTrials
+    AttrWidget* outAvgTrials = addGeneralAttr(m_treeItemOutputs, OUTPUT_AVGTRIALS);
+    outAvgTrials->setToolTip("save a single file with the mean, variance,\n"
+                             "min, max and median of all trials\n"
+                             "(with more trials than threads, the saved steps\n"
+                             "are kept in memory until all trials reach them)");
+    outAvgTrials->setValue(false);
+
+    // -- frames
+    AttrWidget* outFrames = addGeneralAttr(m_treeItemOutputs, OUTPUT_FRAMES);
+    outFrames->setToolTip("name of a node attribute to be saved as images\n"
+                          "in the output directory; empty to disable");
+    outFrames->setValue(Value(""));
+    AttrWidget* outFramesInterval = addGeneralAttr(m_treeItemOutputs, OUTPUT_FRAMESINTERVAL);
+    outFramesInterval->setToolTip("save an image every n steps");
+    outFramesInterval->setValue(1);
+
     connect(m_enableOutputs, &AttrWidget::valueChanged,
-        [this, outDir, outHeader]() {
+        [this, outDir, outHeader, outStartAt, outInterval, outSaveSteps, outAvgTrials,
+         outFrames, outFramesInterval]() {
             bool b = m_enableOutputs->value().toBool();
             outDir->setEnabled(b);
             outHeader->setEnabled(b);
-//          outAvgTrials->setEnabled(b);
+            outStartAt->setEnabled(b);
+            outInterval->setEnabled(b);
+            outSaveSteps->setEnabled(b);
+            outAvgTrials->setEnabled(b);
+            outFrames->setEnabled(b);
+            outFramesInterval->setEnabled(b);
         });
     m_enableOutputs->setValue(true);
     m_enableOutputs->setValue(false);
@@ -417,8 +439,9 @@ std::unique_ptr<ExpInputs> ExperimentDesigner::readInputs(const int expId, QStri
         return nullptr;
     } else if (m_enableOutputs->value().toBool()
                && (m_attrWidgets.value(OUTPUT_DIR)->value().toQString().isEmpty()
-                   || m_attrWidgets.value(OUTPUT_HEADER)->value().toQString().isEmpty())) {
-        error = "Please, insert a valid output directory and a output header.";
+                   || (m_attrWidgets.value(OUTPUT_HEADER)->value().toQString().isEmpty()
+                       && m_attrWidgets.value(OUTPUT_FRAMES)->value().toQString().isEmpty()))) {
+        error = "Please, insert a valid output directory and a output header (or frames).";
         return nullptr;
     }
 
@@ -23,9 +23,9 @@
 
 #include <QDialog>
 
+#include "core/colormap.h"
 #include "core/experiment.h"
 #include "attrcolorselector.h"
-#include "colormap.h"
 
 class Ui_GraphSettings;
 
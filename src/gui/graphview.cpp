@@ -18,7 +18,9 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QElapsedTimer>
 #include <QPainter>
+#include <QtConcurrent>
 
 #include "core/trial.h"
 
@@ -29,14 +31,26 @@
 
 namespace evoplex {
 
+namespace {
+// the edges are antialiased only from this zoom level
+const float kMinAntialiasedZoom = 0.f;
+// minimum interval (ms) between two positions published by the layout
+const int kLayoutPublishInterval = 100;
+}
+
 GraphView::GraphView(ColorMapMgr* cMgr, ExperimentPtr exp, GraphWidget* parent)
     : BaseGraphGL(exp, parent),
       m_settingsDlg(new GraphSettings(cMgr, exp, this)),
       m_edgeAttr(-1),
       m_edgeCMap(nullptr),
+      m_edgesVersion(0),
       m_edgePen(Qt::gray),
       m_nodePen(Qt::black)
 {
+    // the edges are drawn in the nodes' coordinates (scaled by the painter),
+    // but their width must not change with the zoom level
+    m_edgePen.setCosmetic(true);
+
     m_settingsDlg->init();
     setNodeScale(m_settingsDlg->nodeScale());
     m_edgeScale = m_settingsDlg->edgeScale();
@@ -44,9 +58,9 @@ GraphView::GraphView(ColorMapMgr* cMgr, ExperimentPtr exp, GraphWidget* parent)
     m_showNodes = m_ui->bShowNodes->isChecked();
     m_showEdges = m_ui->bShowEdges->isChecked();
     connect(m_ui->bShowNodes, &QPushButton::clicked,
-        [this](bool b) { m_showNodes = b; updateCache(); });
+        [this](bool b) { m_showNodes = b; invalidateCache(); updateCache(); });
     connect(m_ui->bShowEdges, &QPushButton::clicked,
-        [this](bool b) { m_showEdges = b; updateCache(); });
+        [this](bool b) { m_showEdges = b; invalidateCache(); updateCache(); });
 
     updateNodePen();
     m_origin += m_origin; // double margin
@@ -54,8 +68,12 @@ GraphView::GraphView(ColorMapMgr* cMgr, ExperimentPtr exp, GraphWidget* parent)
     setTrial(0); // init at trial 0
 }
 
-GraphView::Star GraphView::createStar(const Node& node,
-        const qreal& edgeSizeRate, const QPointF& xy)
+GraphView::~GraphView()
+{
+    stopLayout();
+}
+
+GraphView::Star GraphView::createStar(const Node& node, const QPointF& xy)
 {
     Star star;
     star.xy = xy;
@@ -67,67 +85,192 @@ GraphView::Star GraphView::createStar(const Node& node,
     if (m_showEdges) {
         star.edges.reserve(node.outEdges().size());
         for (auto const& ep : node.outEdges()) {
-            QPointF xy2 = nodePoint(ep.second.neighbour(), edgeSizeRate);
-            QLineF line(xy, xy2);
-            // just add the visible edges
-            if (!m_showNodes || line.length() - m_nodeRadius * 2. > 4.0) {
-                star.edges.push_back({ep.second, line});
-            }
+            const Node& neighbour = ep.second.neighbour();
+            star.edges.push_back({ep.second, QLineF(xy, QPointF(neighbour.x(), neighbour.y()))});
         }
-        star.edges.shrink_to_fit();
     }
 
     return star;
 }
 
+void GraphView::stepChanged()
+{
+    // the tiles hold the edges, so they are only rebuilt if the model
+    // has added or removed edges (the nodes are checked by the index)
+    const AbstractGraph* graph = m_trial ? m_trial->graph() : nullptr;
+    const quint64 version = graph ? graph->edgesVersion() : 0;
+    if (m_edgesVersion != version) {
+        m_edgesVersion = version;
+        if (m_showEdges) {
+            invalidateCache();
+        }
+    }
+}
+
 CacheStatus GraphView::refreshCache()
 {
     if (paintingActive()) {
         return CacheStatus::Scheduled;
     }
-    Utils::clearAndShrink(m_cache);
-    if (!m_trial || !m_trial->graph() || (!m_showNodes && !m_showEdges)) {
+    if (!m_trial || !m_trial->graph()) {
+        m_tiles.clear();
+        m_nodesIndex.clear();
+        return CacheStatus::Ready;
+    }
+
+    const Nodes& nodes = m_trial->graph()->nodes();
+    if (ForceLayout::lacksCoords(nodes)) {
+        // nothing to cache until the nodes are scattered (in the GUI thread)
+        QMetaObject::invokeMethod(this, "startLayout", Qt::QueuedConnection);
+        return CacheStatus::Scheduled;
+    }
+
+    const bool outdated = updateNodesIndex(m_trial->graph());
+    if (outdated) {
+        m_tiles.clear();
+    }
+    if (!m_showNodes && !m_showEdges) {
+        m_tiles.clear();
         return CacheStatus::Ready;
     }
 
+    // about 32x32 tiles over the whole graph
+    const QRectF& bounds = m_nodesIndex.bounds();
+    m_tiles.setTileSize(qMax(qMax(bounds.width(), bounds.height()) / 32., 1e-3));
+
     const qreal edgeSR = currEdgeSize();
     const int m = qRound(edgeSR);
     QRectF frame = rect().translated(-m_origin.toPoint());
     frame = frame.marginsAdded(QMargins(m, m, m, m));
 
-    m_cache.reserve(m_trial->graph()->nodes().size());
-    for (auto const& np : m_trial->graph()->nodes()) {
-        QPointF xy = nodePoint(np.second, edgeSR);
-        if (!frame.contains(xy)) {
-            continue;
+    // the frame in the nodes' coordinates
+    const qreal t = m_tiles.tileSize();
+    QRectF area(frame.topLeft() / edgeSR, frame.size() / edgeSR);
+    area = area.intersected(bounds.adjusted(-t, -t, t, t));
+
+    m_tiles.update(area, [this](const QRectF& tileArea, Tile& tile) {
+        m_nodesIndex.forEachIn(tileArea, [this, &tileArea, &tile](const Node& node, const QPointF& xy) {
+            if (!TileCache<Tile>::contains(tileArea, xy)) {
+                return;
+            }
+            if (m_showNodes) {
+                tile.stars.push_back({node, xy, {}});
+            }
+            if (m_showEdges) {
+                for (auto const& ep : node.outEdges()) {
+                    const Node& neighbour = ep.second.neighbour();
+                    tile.lines.push_back(QLineF(xy, QPointF(neighbour.x(), neighbour.y())));
+                    tile.edges.emplace_back(ep.second);
+                }
+            }
+        });
+        tile.stars.shrink_to_fit();
+        tile.lines.squeeze();
+        tile.edges.shrink_to_fit();
+    });
+
+    return CacheStatus::Ready;
+}
+
+void GraphView::startLayout()
+{
+    if (m_cacheStatus == CacheStatus::Updating) {
+        // refreshCache() might be reading the coordinates; try again later
+        QTimer::singleShot(10, this, SLOT(startLayout()));
+        return;
+    }
+    if (!m_trial || !m_trial->graph() || !ForceLayout::lacksCoords(m_trial->graph()->nodes())) {
+        return; // e.g., it was already requested
+    }
+    stopLayout();
+
+    // the nodes are scattered at once and moved in the background
+    auto job = std::make_shared<LayoutJob>();
+    job->layout = std::make_shared<ForceLayout>(m_trial->graph()->nodes());
+    job->layout->apply();
+    invalidateNodesIndex();
+    updateCache();
+
+    m_layoutJob = job;
+    m_layoutFuture = QtConcurrent::run([this, job]() {
+        ForceLayout& layout = *job->layout;
+        QElapsedTimer timer;
+        timer.start();
+        bool done = false;
+        while (!done && !job->stop) {
+            done = layout.iterate();
+            if (done || timer.elapsed() > kLayoutPublishInterval) {
+                QMutexLocker locker(&job->mutex);
+                job->coords.resize(layout.size());
+                for (size_t i = 0; i < layout.size(); ++i) {
+                    job->coords[i] = QPointF(layout.x(i), layout.y(i));
+                }
+                job->fresh = true;
+                QMetaObject::invokeMethod(this, "applyLayout", Qt::QueuedConnection);
+                timer.restart();
+            }
         }
-        m_cache.emplace_back(createStar(np.second, edgeSR, xy));
+    });
+}
+
+void GraphView::stopLayout()
+{
+    if (m_layoutJob) {
+        m_layoutJob->stop = true;
+        m_layoutFuture.waitForFinished();
+        m_layoutJob.reset();
     }
-    m_cache.shrink_to_fit();
+}
 
-    return CacheStatus::Ready;
+void GraphView::applyLayout()
+{
+    if (!m_layoutJob) {
+        return;
+    }
+    if (m_cacheStatus != CacheStatus::Ready) {
+        // refreshCache() is reading the coordinates; try again later
+        QTimer::singleShot(10, this, SLOT(applyLayout()));
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_layoutJob->mutex);
+        if (!m_layoutJob->fresh) {
+            return;
+        }
+        const ForceLayout& layout = *m_layoutJob->layout;
+        for (size_t i = 0; i < m_layoutJob->coords.size(); ++i) {
+            const QPointF& xy = m_layoutJob->coords[i];
+            Node(layout.node(i)).setCoords(static_cast<float>(xy.x()), static_cast<float>(xy.y()));
+        }
+        m_layoutJob->fresh = false;
+    }
+
+    const Node selected = m_selectedStar.node;
+    if (!selected.isNull()) {
+        m_selectedStar = createStar(selected, QPointF(selected.x(), selected.y()));
+    }
+    invalidateNodesIndex();
+    updateCache();
 }
 
 Node GraphView::selectNode(const QPointF& pos, bool center)
 {
     m_selectedStar = Star();
-    if (m_cacheStatus != CacheStatus::Ready) {
+    if (m_cacheStatus != CacheStatus::Ready || !m_showNodes) {
         return Node();
     }
 
-    const QPointF p = pos - m_origin;
-    for (const Star& star : m_cache) {
-        if (p.x() > star.xy.x()-m_nodeRadius &&
-            p.x() < star.xy.x()+m_nodeRadius &&
-            p.y() > star.xy.y()-m_nodeRadius &&
-            p.y() < star.xy.y()+m_nodeRadius)
-        {
-            m_selectedStar = star;
-            if (center) { m_origin = rect().center() - star.xy; }
-            return star.node;
-        }
+    const qreal edgeSR = currEdgeSize();
+    const QPointF p = (pos - m_origin) / edgeSR;
+    const Node node = m_nodesIndex.nodeAt(p, m_nodeRadius / edgeSR);
+    if (node.isNull()) {
+        return Node();
     }
-    return Node();
+
+    m_selectedStar = createStar(node, QPointF(node.x(), node.y()));
+    if (center) { m_origin = rect().center() - nodePoint(node, edgeSR); }
+    return node;
 }
 
 bool GraphView::selectNode(const Node& node, bool center)
@@ -138,16 +281,14 @@ bool GraphView::selectNode(const Node& node, bool center)
     }
 
     const QPointF p = nodePoint(node, currEdgeSize());
-    for (const Star& star : m_cache) {
-        if (star.xy == p) {
-            m_selectedStar = star;
-            if (center) { m_origin = rect().center() - p; }
-            return true;
-        }
+    m_selectedStar = createStar(node, QPointF(node.x(), node.y()));
+    if (QRectF(rect()).translated(-m_origin).contains(p)) {
+        if (center) { m_origin = rect().center() - p; }
+        return true;
     }
 
-    m_selectedStar = createStar(node, currEdgeSize(), p);
-    m_origin = rect().center() - m_selectedStar.xy;
+    // it's out of the screen
+    m_origin = rect().center() - p;
     updateCache();
     return true;
 }
@@ -156,6 +297,7 @@ void GraphView::setEdgeCMap(ColorMap* cmap)
 {
     m_edgeCMap = cmap;
     m_edgeAttr = cmap ? cmap->attrRange()->id() : -1;
+    m_edgeBuckets.clear();
     update();
 }
 
@@ -168,6 +310,7 @@ void GraphView::setEdgeScale(int v)
 void GraphView::setEdgeWidth(int v)
 {
     m_edgePen = QPen(Qt::gray, v);
+    m_edgePen.setCosmetic(true);
     update();
 }
 
@@ -196,11 +339,14 @@ void GraphView::paintFrame(QPainter& painter) const
     drawSelectedStar(painter, nodeRadius);
 }
 
-void GraphView::drawNode(QPainter& painter, const Star& s, double r) const
+void GraphView::drawNode(QPainter& painter, const Node& node, const QPointF& xy, double r) const
 {
-    const Value& value = s.node.attr(m_nodeAttr);
-    painter.setBrush(m_nodeCMap->colorFromValue(value));
-    painter.drawEllipse(s.xy, r, r);
+    const QRgb rgb = nodeRgb(node);
+    const QBrush& brush = painter.brush();
+    if (brush.style() != Qt::SolidPattern || brush.color().rgba() != rgb) { // neighbours tend to share it
+        painter.setBrush(QColor::fromRgba(rgb));
+    }
+    painter.drawEllipse(xy, r, r);
 }
 
 void GraphView::drawNodes(QPainter& painter, double nodeRadius) const
@@ -208,39 +354,65 @@ void GraphView::drawNodes(QPainter& painter, double nodeRadius) const
     if (!m_showNodes || m_nodeAttr < 0 || !m_nodeCMap) {
         return;
     }
+    const qreal edgeSR = currEdgeSize();
     painter.save();
     painter.setPen(m_nodePen);
-    for (const Star& star : m_cache) {
-        if (star.node.isNull()) {
-            break;
+    for (const Tile* tile : m_tiles.visible()) {
+        for (const Star& star : tile->stars) {
+            drawNode(painter, star.node, star.xy * edgeSR, nodeRadius);
         }
-        drawNode(painter, star, nodeRadius);
     }
     painter.restore();
 }
 
+QVector<QLineF>& GraphView::edgeBucket(QRgb rgb, size_t& hint) const
+{
+    // there are just a few colours, and the neighbour edges tend to share them
+    if (hint < m_edgeBuckets.size() && m_edgeBuckets[hint].first == rgb) {
+        return m_edgeBuckets[hint].second;
+    }
+    for (hint = 0; hint < m_edgeBuckets.size(); ++hint) {
+        if (m_edgeBuckets[hint].first == rgb) {
+            return m_edgeBuckets[hint].second;
+        }
+    }
+    hint = m_edgeBuckets.size();
+    m_edgeBuckets.push_back({rgb, QVector<QLineF>()});
+    return m_edgeBuckets.back().second;
+}
+
 void GraphView::drawEdges(QPainter& painter) const
 {
     if (!m_showEdges) {
         return;
     }
+
     painter.save();
+    painter.setRenderHint(QPainter::Antialiasing, m_zoomLevel >= kMinAntialiasedZoom);
+    painter.scale(currEdgeSize(), currEdgeSize());
     if (m_edgeAttr >= 0 && m_edgeCMap) {
+        for (auto& bucket : m_edgeBuckets) {
+            bucket.second.resize(0); // keeps the capacity
+        }
+        size_t hint = 0;
+        for (const Tile* tile : m_tiles.visible()) {
+            for (int i = 0; i < tile->lines.size(); ++i) {
+                const Value& value = tile->edges[static_cast<size_t>(i)].attr(m_edgeAttr);
+                edgeBucket(m_edgeCMap->rgb(value), hint).append(tile->lines.at(i));
+            }
+        }
         QPen pen = m_edgePen;
-        for (const Star& star : m_cache) {
-            for (auto const& ep : star.edges) {
-                const Value& value = ep.first.attr(m_edgeAttr);
-                pen.setColor(m_edgeCMap->colorFromValue(value));
-                painter.setPen(m_edgePen);
-                painter.drawLine(ep.second);
+        for (auto const& bucket : m_edgeBuckets) {
+            if (!bucket.second.isEmpty()) {
+                pen.setColor(QColor::fromRgba(bucket.first));
+                painter.setPen(pen);
+                painter.drawLines(bucket.second);
             }
         }
     } else {
         painter.setPen(m_edgePen);
-        for (const Star& star : m_cache) {
-            for (auto const& ep : star.edges) {
-                painter.drawLine(ep.second);
-            }
+        for (const Tile* tile : m_tiles.visible()) {
+            painter.drawLines(tile->lines);
         }
     }
     painter.restore();
@@ -253,36 +425,41 @@ void GraphView::drawSelectedStar(QPainter& painter, double nodeRadius) const
     }
 
     painter.setOpacity(1.0);
+    const qreal esize = currEdgeSize();
+    const QPointF xy = m_selectedStar.xy * esize;
 
     // draw shadow of the seleted node
     painter.save();
     double shadowRadius = nodeRadius*1.5;
-    QRadialGradient r(m_selectedStar.xy, shadowRadius, m_selectedStar.xy);
+    QRadialGradient r(xy, shadowRadius, xy);
     r.setColorAt(0, Qt::black);
     r.setColorAt(1, m_background.color());
     painter.setBrush(r);
     painter.setPen(Qt::transparent);
-    painter.drawEllipse(m_selectedStar.xy, shadowRadius, shadowRadius);
+    painter.drawEllipse(xy, shadowRadius, shadowRadius);
     painter.restore();
 
-    painter.save();
     // highlight immediate edges
-    painter.setPen(QPen(Qt::darkGray, m_edgePen.width() + 3));
+    painter.save();
+    painter.scale(esize, esize);
+    QPen edgePen(Qt::darkGray, m_edgePen.width() + 3);
+    edgePen.setCosmetic(true);
+    painter.setPen(edgePen);
     for (auto const& ep : m_selectedStar.edges) {
         painter.drawLine(ep.second);
     }
+    painter.restore();
 
+    painter.save();
     // draw selected node
     painter.setPen(m_nodePen);
-    drawNode(painter, m_selectedStar, nodeRadius);
+    drawNode(painter, m_selectedStar.node, xy, nodeRadius);
 
     // draw neighbours
     const Edges& oe = m_selectedStar.node.outEdges();
-    const double esize = currEdgeSize();
     for (auto const& e : oe) {
         const Node& n = e.second.neighbour();
-        Star s(n, nodePoint(n, esize), {});
-        drawNode(painter, s, nodeRadius);
+        drawNode(painter, n, nodePoint(n, esize), nodeRadius);
     }
     painter.restore();
 }
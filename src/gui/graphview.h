@@ -21,8 +21,13 @@
 #ifndef GRAPHVIEW_H
 #define GRAPHVIEW_H
 
+#include <QFuture>
+
+#include "core/forcelayout.h"
+
 #include "basegraphgl.h"
 #include "graphsettings.h"
+#include "tilecache.h"
 
 namespace evoplex {
 
@@ -32,6 +37,7 @@ class GraphView : public BaseGraphGL
 
 public:
     explicit GraphView(ColorMapMgr* cMgr, ExperimentPtr exp, GraphWidget* parent);
+    ~GraphView() override;
 
 public slots:
     inline void zoomIn() override;
@@ -48,9 +54,13 @@ protected:
     inline QPointF selectedNodePos() const override;
     inline void clearSelection() override;
     CacheStatus refreshCache() override;
+    inline void releaseTrial() override;
+    void stepChanged() override;
 
 private slots:
     void setEdgeCMap(ColorMap* cmap);
+    void startLayout();
+    void applyLayout();
 
 private:
     GraphSettings* m_settingsDlg;
@@ -61,28 +71,55 @@ private:
 
     bool m_showNodes;
     bool m_showEdges;
+    quint64 m_edgesVersion; // the graph's edgesVersion() seen in the last step
 
     QPen m_edgePen;
     QPen m_nodePen;
     void updateNodePen();
 
+    // a node and its out edges in the nodes' coordinates,
+    // i.e., they are scaled by 'currEdgeSize()' when drawn
     struct Star {
         Node node;
         QPointF xy;
         std::vector<std::pair<Edge,QLineF>> edges;
-        Star() {}
-        Star(Node n, QPointF xy, std::vector<std::pair<Edge,QLineF>> e)
-            : node(n), xy(xy), edges(e) {}
     };
-    std::vector<Star> m_cache;
+    // The edges of a tile are kept in a contiguous buffer of lines (and the
+    // corresponding edges), so they can be drawn with a single call.
+    struct Tile {
+        std::vector<Star> stars; // without edges
+        QVector<QLineF> lines;
+        std::vector<Edge> edges;
+    };
+    TileCache<Tile> m_tiles;
+
+    // lines of the visible edges bucketed by their colour
+    mutable std::vector<std::pair<QRgb, QVector<QLineF>>> m_edgeBuckets;
+    QVector<QLineF>& edgeBucket(QRgb rgb, size_t& hint) const;
     Star m_selectedStar;
-    Star createStar(const Node& node, const qreal& edgeSizeRate, const QPointF& xy);
+    Star createStar(const Node& node, const QPointF& xy);
 
-    void drawNode(QPainter& painter, const Star& s, double r) const;
+    void drawNode(QPainter& painter, const Node& node, const QPointF& xy, double r) const;
     void drawEdges(QPainter& painter) const;
     void drawNodes(QPainter& painter, double nodeRadius) const;
     void drawSelectedStar(QPainter& painter, double nodeRadius) const;
 
+    // Graphs without coordinates are laid out by a ForceLayout running in
+    // the background. It's set up in the GUI thread, and it publishes the
+    // positions every now and then, which are also written into the nodes
+    // in the GUI thread while no cache is being built (i.e., nothing else
+    // reads the coordinates meanwhile).
+    struct LayoutJob {
+        std::shared_ptr<ForceLayout> layout;
+        std::atomic<bool> stop{false};
+        QMutex mutex;
+        std::vector<QPointF> coords; // the last positions published
+        bool fresh = false;          // true if 'coords' were not applied yet
+    };
+    std::shared_ptr<LayoutJob> m_layoutJob;
+    QFuture<void> m_layoutFuture;
+    void stopLayout();
+
     inline qreal currEdgeSize() const;
     inline QPointF nodePoint(const Node& node, const qreal& edgeSizeRate) const;
 };
@@ -91,7 +128,10 @@ inline Node GraphView::selectedNode() const
 { return m_selectedStar.node; }
 
 inline QPointF GraphView::selectedNodePos() const
-{ return m_selectedStar.xy + m_origin; }
+{ return m_selectedStar.xy * currEdgeSize() + m_origin; }
+
+inline void GraphView::releaseTrial()
+{ stopLayout(); }
 
 inline void GraphView::clearSelection()
 { m_selectedStar = Star(); BaseGraphGL::clearSelection(); }
@@ -18,7 +18,9 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <climits>
 #include <QPainter>
+#include <QtMath>
 
 #include "core/trial.h"
 
@@ -29,9 +31,45 @@
 
 namespace evoplex {
 
+namespace {
+// number of cells in each side of a tile
+const int kTileCells = 64;
+// cells larger than it (in pixels) are drawn one by one
+const qreal kMaxRasterCellLength = 16.;
+// the coarsest level of detail, i.e., a whole tile in one pixel
+const int kMaxLodLevel = 6; // log2(kTileCells)
+// index of the first block of each level in the pyramid of a tile
+const int kLevelOffsets[kMaxLodLevel + 2] = {0, 4096, 5120, 5376, 5440, 5456, 5460, 5461};
+// the cell of a node id which is not in the graph
+const QPoint kNoCell(INT_MIN, INT_MIN);
+
+// index of the block of 'level' which contains the cell 'pixel'
+inline int blockOf(int level, int pixel)
+{
+    const int row = (pixel / kTileCells) >> level;
+    const int col = (pixel % kTileCells) >> level;
+    return kLevelOffsets[level] + row * (kTileCells >> level) + col;
+}
+
+inline bool toNumber(const Value& value, double& number)
+{
+    if (value.type() == Value::INT) {
+        number = value.toInt();
+    } else if (value.type() == Value::DOUBLE) {
+        number = value.toDouble();
+    } else {
+        number = 0.;
+        return false;
+    }
+    return true;
+}
+}
+
 GridView::GridView(ColorMapMgr* cMgr, ExperimentPtr exp, GraphWidget* parent)
     : BaseGraphGL(exp, parent),
-      m_settingsDlg(new GridSettings(cMgr, exp, this))
+      m_settingsDlg(new GridSettings(cMgr, exp, this)),
+      m_numeric(false),
+      m_syncedVersion(~0u)
 {
     connect(m_settingsDlg->nodeColorSelector(),
             SIGNAL(cmapUpdated(ColorMap*)), SLOT(setNodeCMap(ColorMap*)));
@@ -47,31 +85,48 @@ CacheStatus GridView::refreshCache()
     if (paintingActive()) {
         return CacheStatus::Scheduled;
     }
-    Utils::clearAndShrink(m_cache);
     if (!m_trial || !m_trial->graph()) {
+        m_tiles.clear();
+        m_nodesIndex.clear();
+        m_nodeCells.clear();
         return CacheStatus::Ready;
     }
 
-    const Nodes& nodes = m_trial->graph()->nodes();
-    m_cache.reserve(nodes.size());
+    if (updateNodesIndex(m_trial->graph())) {
+        m_tiles.clear();
+        const Nodes& nodes = m_trial->graph()->nodes();
+        m_nodeCells.assign(nodes.size(), kNoCell);
+        for (auto const& np : nodes) {
+            const size_t id = static_cast<size_t>(np.first);
+            if (id >= m_nodeCells.size()) {
+                m_nodeCells.resize(id + 1, kNoCell);
+            }
+            m_nodeCells[id] = QPoint(qFloor(np.second.x()), qFloor(np.second.y()));
+        }
+    }
+    m_tiles.setTileSize(kTileCells);
 
     const double nodeRadius = m_nodeRadius;
     const int m = qRound(nodeRadius * 2.0);
     QRectF frame = rect().translated(-m_origin.toPoint());
     frame = frame.marginsAdded(QMargins(m, m, m, m));
 
-    for (auto const& np : nodes) {
-        QRectF r = cellRect(np.second, nodeRadius);
-        if (!frame.contains(r.x(), r.y())) {
-            continue;
-        }
+    // the visible region in cells, i.e., in the nodes' coordinates
+    QRectF cells(frame.topLeft() / nodeRadius, frame.size() / nodeRadius);
+    cells = cells.intersected(m_nodesIndex.bounds().adjusted(-1, -1, 1, 1));
 
-        Cell c;
-        c.node = np.second;
-        c.rect = r;
-        m_cache.emplace_back(c);
-    }
-    m_cache.shrink_to_fit();
+    m_tiles.update(cells, [this](const QRectF& tileArea, Tile& tile) {
+        tile.area = tileArea;
+        m_nodesIndex.forEachIn(tileArea, [&tileArea, &tile](const Node& node, const QPointF& xy) {
+            if (!TileCache<Tile>::contains(tileArea, xy)) {
+                return;
+            }
+            const int col = qBound(0, qFloor(xy.x() - tileArea.left()), kTileCells - 1);
+            const int row = qBound(0, qFloor(xy.y() - tileArea.top()), kTileCells - 1);
+            tile.cells.push_back({node.id(), row * kTileCells + col});
+        });
+        tile.cells.shrink_to_fit();
+    });
 
     return CacheStatus::Ready;
 }
@@ -82,74 +137,291 @@ void GridView::paintFrame(QPainter& painter) const
         return;
     }
 
-    painter.setOpacity(m_selectedCell.node.isNull() ? 1.0 : 0.2);
+    syncTiles();
+
+    painter.setOpacity(m_selectedNode.isNull() ? 1.0 : 0.2);
     painter.setPen(Qt::transparent);
 
-    for (const Cell& cell : m_cache) {
-        if (cell.node.isNull()) {
-            break;
+    if (m_nodeRadius <= kMaxRasterCellLength) {
+        const int level = lodLevel();
+        for (const Tile* tile : m_tiles.visible()) {
+            rasterTile(painter, *tile, level);
+        }
+    } else {
+        const qreal length = m_nodeRadius;
+        for (const Tile* tile : m_tiles.visible()) {
+            for (const Cell& cell : tile->cells) {
+                const QPointF xy = tile->area.topLeft() +
+                        QPointF(cell.pixel % kTileCells, cell.pixel / kTileCells);
+                painter.setBrush(QColor::fromRgba(valueRgb(nodeValue(cell.nodeId))));
+                painter.drawRect(QRectF(xy * length, QSizeF(length, length)));
+            }
         }
-        drawCell(painter, cell);
     }
 
-    if (!m_selectedCell.node.isNull()) {
+    if (!m_selectedNode.isNull()) {
         painter.setOpacity(1.0);
         // draw neighbours
-        for (auto const& n : m_selectedCell.node.outEdges()) {
-            drawCell(painter, {n, cellRect(n, m_nodeRadius)});
+        for (auto const& n : m_selectedNode.outEdges()) {
+            drawCell(painter, n.second.neighbour());
         }
         // draw selected node
-        drawCell(painter, m_selectedCell);
+        drawCell(painter, m_selectedNode);
         painter.setBrush(QBrush(m_background.color(), Qt::DiagCrossPattern));
-        painter.drawRect(m_selectedCell.rect);
+        painter.drawRect(cellRect(m_selectedNode, m_nodeRadius));
     }
 }
 
 Node GridView::selectNode(const QPointF& pos, bool center)
 {
-    m_selectedCell = Cell();
+    m_selectedNode = Node();
     if (m_cacheStatus != CacheStatus::Ready) {
         return Node();
     }
 
-    const QPointF p = pos - m_origin;
-    for (const Cell& cell : m_cache) {
-        if (cell.rect.contains(p)) {
-            m_selectedCell = cell;
-            if (center) { m_origin = rect().center() - cell.rect.center(); }
-            return cell.node;
-        }
+    // the top-left corner of the cell under 'pos' is within one cell length
+    const qreal length = m_nodeRadius;
+    const QPointF p = (pos - m_origin) / length - QPointF(0.5, 0.5);
+    m_selectedNode = m_nodesIndex.nodeAt(p, 0.5);
+    if (!m_selectedNode.isNull() && center) {
+        m_origin = rect().center() - cellRect(m_selectedNode, length).center();
     }
-    return Node();
+    return m_selectedNode;
 }
 
 bool GridView::selectNode(const Node& node, bool center)
 {
-    m_selectedCell = Cell();
+    m_selectedNode = Node();
     if (m_cacheStatus != CacheStatus::Ready) {
         return false;
     }
 
     const QRectF p = cellRect(node, m_nodeRadius);
-    for (const Cell& cell : m_cache) {
-        if (cell.rect == p) {
-            m_selectedCell = cell;
-            if (center) { m_origin = rect().center() - p.center(); }
-            return true;
-        }
+    m_selectedNode = node;
+    if (QRectF(rect()).translated(-m_origin).contains(p.center())) {
+        if (center) { m_origin = rect().center() - p.center(); }
+        return true;
     }
 
-    m_selectedCell = {node, p};
+    // it's out of the screen
     m_origin = rect().center() - p.center();
     updateCache();
     return true;
 }
 
-void GridView::drawCell(QPainter& painter, const Cell& cell) const
+int GridView::lodLevel() const
+{
+    // the largest block of cells which is still within a pixel
+    int level = 0;
+    qreal blockLength = m_nodeRadius;
+    while (level < kMaxLodLevel && blockLength * 2. <= 1.) {
+        blockLength *= 2.;
+        ++level;
+    }
+    return level;
+}
+
+void GridView::syncTiles() const
+{
+    if (m_syncedVersion == m_valuesVersion) {
+        return;
+    }
+    const std::vector<int>* changed =
+            m_syncedVersion + 1 == m_valuesVersion ? changedNodes() : nullptr;
+    m_syncedVersion = m_valuesVersion;
+
+    if (!changed) {
+        // the values were reset (e.g., another colormap or trial),
+        // so the tiles will be rebuilt as they are drawn
+        const AttributeRange::Type rangeType = m_nodeCMap->attrRange()->type();
+        m_numeric = rangeType == AttributeRange::Int_Range ||
+                    rangeType == AttributeRange::Double_Range;
+        m_palette.assign(1, 0);
+        for (const QColor& c : m_nodeCMap->colors()) {
+            if (m_palette.size() > UCHAR_MAX) {
+                break; // the others are drawn as transparent
+            }
+            m_palette.emplace_back(c.rgba());
+        }
+        return;
+    }
+
+    // the visible tiles in sync with the previous values take the changes;
+    // the others are rebuilt if they are drawn
+    const quint32 prevVersion = m_valuesVersion - 1;
+    for (const Tile* tile : m_tiles.visible()) {
+        if (tile->level >= 0 && tile->version == prevVersion) {
+            tile->version = m_valuesVersion;
+        }
+    }
+    for (const int id : *changed) {
+        if (id < 0 || static_cast<size_t>(id) >= m_nodeCells.size()) {
+            continue;
+        }
+        const QPoint& cell = m_nodeCells[static_cast<size_t>(id)];
+        const Tile* tile = cell == kNoCell ? nullptr : m_tiles.tileAt(cell);
+        if (tile && tile->level >= 0 && tile->version == m_valuesVersion) {
+            const int col = cell.x() - qFloor(tile->area.left());
+            const int row = cell.y() - qFloor(tile->area.top());
+            updateCell(*tile, row * kTileCells + col, nodeValue(id));
+        }
+    }
+}
+
+void GridView::rasterTile(QPainter& painter, const Tile& tile, int level) const
+{
+    if (tile.cells.empty()) {
+        return;
+    }
+
+    if (tile.level < 0 || tile.version != m_valuesVersion) {
+        buildPyramid(tile);
+        tile.version = m_valuesVersion;
+        tile.level = -1;
+    }
+    if (tile.level != level) {
+        renderTile(tile, level);
+        tile.level = level;
+    }
+
+    const qreal length = m_nodeRadius;
+    const QRectF target(tile.area.topLeft() * length, tile.area.size() * length);
+    painter.save();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter.drawImage(target, tile.image);
+    painter.restore();
+}
+
+void GridView::buildPyramid(const Tile& tile) const
+{
+    const int numCells = kTileCells * kTileCells;
+    const int numBlocks = kLevelOffsets[kMaxLodLevel + 1];
+
+    if (m_numeric) {
+        tile.sums.assign(static_cast<size_t>(numBlocks), 0.);
+        tile.counts.assign(static_cast<size_t>(numBlocks), 0);
+        tile.colors.clear();
+        for (const Cell& cell : tile.cells) {
+            double v;
+            tile.counts[cell.pixel] = toNumber(nodeValue(cell.nodeId), v) ? 1 : 0;
+            tile.sums[cell.pixel] = v;
+        }
+        for (int pixel = 0; pixel < numCells; ++pixel) {
+            if (tile.counts[pixel] == 0) {
+                continue;
+            }
+            for (int level = 1; level <= kMaxLodLevel; ++level) {
+                const int b = blockOf(level, pixel);
+                tile.sums[b] += tile.sums[pixel];
+                ++tile.counts[b];
+            }
+        }
+        return;
+    }
+
+    const size_t numColors = m_palette.size();
+    tile.sums.clear();
+    tile.colors.assign(static_cast<size_t>(numCells), 0);
+    tile.counts.assign(static_cast<size_t>(numBlocks - kLevelOffsets[1]) * numColors, 0);
+    for (const Cell& cell : tile.cells) {
+        tile.colors[cell.pixel] = colorOf(nodeValue(cell.nodeId));
+    }
+    for (int pixel = 0; pixel < numCells; ++pixel) {
+        for (int level = 1; level <= kMaxLodLevel; ++level) {
+            const size_t b = static_cast<size_t>(blockOf(level, pixel) - kLevelOffsets[1]);
+            ++tile.counts[b * numColors + tile.colors[pixel]];
+        }
+    }
+}
+
+void GridView::renderTile(const Tile& tile, int level) const
+{
+    const int side = kTileCells >> level;
+    if (tile.image.width() != side) {
+        tile.image = QImage(side, side, QImage::Format_ARGB32);
+    }
+    // ARGB32 rows are never padded, so the blocks are just an array of pixels
+    QRgb* pixels = reinterpret_cast<QRgb*>(tile.image.bits());
+    const int offset = kLevelOffsets[level];
+    for (int b = 0; b < side * side; ++b) {
+        pixels[b] = blockRgb(tile, offset + b);
+    }
+}
+
+void GridView::updateCell(const Tile& tile, int pixel, const Value& value) const
+{
+    if (m_numeric) {
+        double v;
+        const int count = toNumber(value, v) ? 1 : 0;
+        const double dSum = v - tile.sums[pixel];
+        const int dCount = count - tile.counts[pixel];
+        if (dSum == 0. && dCount == 0) {
+            return;
+        }
+        tile.sums[pixel] = v;
+        tile.counts[pixel] = static_cast<quint16>(count);
+        for (int level = 1; level <= kMaxLodLevel; ++level) {
+            const int b = blockOf(level, pixel);
+            tile.sums[b] += dSum;
+            tile.counts[b] = static_cast<quint16>(tile.counts[b] + dCount);
+        }
+    } else {
+        const quint8 color = colorOf(value);
+        const quint8 prevColor = tile.colors[pixel];
+        if (color == prevColor) {
+            return;
+        }
+        tile.colors[pixel] = color;
+        const size_t numColors = m_palette.size();
+        for (int level = 1; level <= kMaxLodLevel; ++level) {
+            const size_t b = static_cast<size_t>(blockOf(level, pixel) - kLevelOffsets[1]) * numColors;
+            --tile.counts[b + prevColor];
+            ++tile.counts[b + color];
+        }
+    }
+
+    // the pixel of the image is the block which contains the cell
+    const int block = blockOf(tile.level, pixel);
+    QRgb* pixels = reinterpret_cast<QRgb*>(tile.image.bits());
+    pixels[block - kLevelOffsets[tile.level]] = blockRgb(tile, block);
+}
+
+QRgb GridView::blockRgb(const Tile& tile, int block) const
+{
+    if (m_numeric) {
+        const quint16 count = tile.counts[block];
+        return count ? valueRgb(Value(tile.sums[block] / count)) : 0;
+    }
+    if (block < kLevelOffsets[1]) {
+        return m_palette[tile.colors[block]];
+    }
+    // the most common colour, which is transparent only if there is no other
+    const size_t numColors = m_palette.size();
+    const quint16* counts = &tile.counts[static_cast<size_t>(block - kLevelOffsets[1]) * numColors];
+    size_t best = 0;
+    for (size_t c = 1; c < numColors; ++c) {
+        if (counts[c] > counts[best] || (best == 0 && counts[c] > 0)) {
+            best = c;
+        }
+    }
+    return m_palette[best];
+}
+
+quint8 GridView::colorOf(const Value& value) const
+{
+    const QRgb rgb = valueRgb(value);
+    for (size_t c = 1; c < m_palette.size(); ++c) {
+        if (m_palette[c] == rgb) {
+            return static_cast<quint8>(c);
+        }
+    }
+    return 0;
+}
+
+void GridView::drawCell(QPainter& painter, const Node& node) const
 {
-    const Value& value = cell.node.attr(m_nodeAttr);
-    painter.setBrush(m_nodeCMap->colorFromValue(value));
-    painter.drawRect(cell.rect);
+    painter.setBrush(QColor::fromRgba(nodeRgb(node)));
+    painter.drawRect(cellRect(node, m_nodeRadius));
 }
 
 } // evoplex
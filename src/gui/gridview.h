@@ -21,8 +21,11 @@
 #ifndef GRIDVIEW_H
 #define GRIDVIEW_H
 
+#include <QImage>
+
 #include "basegraphgl.h"
 #include "gridsettings.h"
+#include "tilecache.h"
 
 namespace evoplex {
 
@@ -46,26 +49,72 @@ protected:
 
 private:
     struct Cell {
-        Node node;
-        QRectF rect;
+        int nodeId;
+        int pixel; // index of the cell in the image of its tile
+    };
+    // The cells of a tile are rasterised into an image, one pixel per cell,
+    // which is then scaled to the cell length and blitted at once.
+    // The cells are drawn one by one only when they are large on screen.
+    //
+    // When the cells are smaller than a pixel, each pixel of the image is
+    // the aggregate of a block of 2^level x 2^level cells instead, i.e., it
+    // costs O(screen pixels) to draw a zoomed out grid. The aggregates of
+    // all levels are kept in a pyramid, which is built once and then updated
+    // with the values changed in each snapshot (see 'syncTiles()'); so is
+    // the image, pixel by pixel.
+    struct Tile {
+        QRectF area; // in cells
+        std::vector<Cell> cells;
+        // The pyramid, from the cells (level 0) to the whole tile, where the
+        // blocks of a level are after the ones of the previous level.
+        // For numeric ranges, the sum and the number of values of each block.
+        // Otherwise, the colour of each cell (index in m_palette) and the
+        // number of cells of each colour in each block above level 0.
+        mutable std::vector<double> sums;
+        mutable std::vector<quint16> counts;
+        mutable std::vector<quint8> colors;
+        mutable QImage image;
+        mutable int level = -1; // of the image, -1 if the pyramid is outdated
+        mutable quint32 version = 0;
     };
-    std::vector<Cell> m_cache;
+    TileCache<Tile> m_tiles;
     GridSettings* m_settingsDlg;
-    Cell m_selectedCell;
+    Node m_selectedNode;
+
+    // the cell of each node (by id), i.e., its coordinates rounded down
+    std::vector<QPoint> m_nodeCells;
+
+    // how the blocks are aggregated, set whenever the values are reset:
+    // by the mean value for numeric ranges, or by the most common colour
+    mutable bool m_numeric;
+    mutable std::vector<QRgb> m_palette; // the colours of m_nodeCMap; 0 is transparent
+    mutable quint32 m_syncedVersion;     // m_valuesVersion of the last 'syncTiles()'
+
+    // the level of detail for the current zoom; 0 is one pixel per cell
+    int lodLevel() const;
+
+    // updates the tiles in sync with the previous values to the current ones
+    void syncTiles() const;
 
-    void drawCell(QPainter& painter, const Cell& cell) const;
+    void rasterTile(QPainter& painter, const Tile& tile, int level) const;
+    void buildPyramid(const Tile& tile) const;
+    void renderTile(const Tile& tile, int level) const;
+    void updateCell(const Tile& tile, int pixel, const Value& value) const;
+    QRgb blockRgb(const Tile& tile, int block) const;
+    quint8 colorOf(const Value& value) const;
+    void drawCell(QPainter& painter, const Node& node) const;
 
     inline QRectF cellRect(const Node& n, double length) const;
 };
 
 inline Node GridView::selectedNode() const
-{ return m_selectedCell.node; }
+{ return m_selectedNode; }
 
 inline QPointF GridView::selectedNodePos() const
-{ return m_selectedCell.rect.center() + m_origin; }
+{ return cellRect(m_selectedNode, m_nodeRadius).center() + m_origin; }
 
 inline void GridView::clearSelection()
-{ m_selectedCell = Cell(); BaseGraphGL::clearSelection(); }
+{ m_selectedNode = Node(); BaseGraphGL::clearSelection(); }
 
 inline QRectF GridView::cellRect(const Node& n, double length) const {
     return QRectF(n.x() * length, n.y() * length, length, length);
@@ -137,6 +137,7 @@ void LineChart::slotRestarted()
 
     for (Series& s : m_series) {
         s.series->clear(); // remove all points
+        s.buffer.clear();
         m_exp->addOutput(s.cache->output()); // make sure we reinsert everything
     }
     m_finished = false;
@@ -167,6 +168,7 @@ void LineChart::setTrial(quint16 trialId)
 
     for (Series& s : m_series) {
         s.series->clear(); // remove all points
+        s.buffer.clear();
         Values inputs = s.cache->inputs(); // keep the same inputs
         OutputPtr parent = s.cache->output(); // keep the same parent
         s.cache->deleteCache();
@@ -196,23 +198,20 @@ void LineChart::updateSeries()
 
     float minX = EVOPLEX_MAX_STEPS;
     float maxY = m_maxY;
+    std::vector<Cache::Row> rows;
     for (Series& s : m_series) {
-        if (s.cache->isEmpty(m_currTrialId)) {
+        // take only the top 10k (max) rows to avoid blocking the UI;
+        // they are taken at once, so the running trial can keep adding rows
+        rows.clear();
+        if (s.cache->takeRows(m_currTrialId, rows, 10000) == 0) {
             continue;
         }
 
-        QVector<QPointF> points = s.series->pointsVector();
-        float x = 0.f;
-        float y = 0.f;
-
-        // read only the top 10k (max) lines to avoid blocking the UI
-        int i = 0;
-        bool lastWasDuplicated = false;
-        do {
-            const Cache::Row& row = s.cache->readFrontRow(m_currTrialId);
+        for (const Cache::Row& row : rows) {
             Q_ASSERT_X(row.second.size() == 1, "LineChart", "it must have only one column");
 
-            x = row.first;
+            const float x = row.first;
+            float y = 0.f;
             if (row.second.at(0).type() == Value::INT) {
                 y = row.second.at(0).toInt();
             } else if (row.second.at(0).type() == Value::DOUBLE) {
@@ -220,30 +219,14 @@ void LineChart::updateSeries()
             } else {
                 qFatal("the type is invalid!");
             }
-            s.cache->flushFrontRow(m_currTrialId);
-
-            // we skip the duplicated rows to reduce the amount of unnecessary points
-            if (!points.isEmpty()) {
-                bool currIsDuplicated = qFuzzyCompare(y, (float) points.last().y());
-                if (lastWasDuplicated && currIsDuplicated) {
-                    points.last().setX(x);
-                    lastWasDuplicated = currIsDuplicated;
-                    continue;
-                }
-                lastWasDuplicated = currIsDuplicated;
-            }
 
-            points.push_back(QPointF(x, y));
+            s.buffer.append(QPointF(x, y));
             if (x < minX) minX = x;
             if (y > maxY) maxY = y;
-            ++i;
-        } while (i < 10000 && !s.cache->isEmpty(m_currTrialId));
-
-        if (lastWasDuplicated) {
-            points.push_back(QPointF(x, y));
         }
 
-        s.series->replace(points);
+        // the series has a bounded number of points, no matter the number of steps
+        s.series->replace(s.buffer.points());
     }
 
     if (minX < EVOPLEX_MAX_STEPS) {
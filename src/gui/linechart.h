@@ -28,6 +28,7 @@
 #include "core/experiment.h"
 
 #include "outputwidget.h"
+#include "seriesbuffer.h"
 
 class Ui_LineChartSettings;
 
@@ -53,6 +54,7 @@ private:
     struct Series {
         QtCharts::QLineSeries* series;
         Cache* cache;
+        SeriesBuffer buffer; // all the points, decimated
     };
 
     Ui_LineChartSettings* m_settingsDlg;
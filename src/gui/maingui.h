@@ -24,8 +24,8 @@
 #include <QAction>
 #include <QMainWindow>
 
+#include "core/colormap.h"
 #include "core/mainapp.h"
-#include "colormap.h"
 
 namespace evoplex {
 
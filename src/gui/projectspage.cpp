@@ -145,10 +145,6 @@ void ProjectsPage::addProjectWidget(ProjectPtr project)
             emit (activeProjectChanged(-1));
         }
     });
-
-    for (auto& i : project->experiments()) {
-        pw->slotInsertRow(i.second->id());
-    }
 }
 
 bool ProjectsPage::slotNewProject()
@@ -23,7 +23,6 @@
 #include <QMainWindow>
 #include <QMenu>
 #include <QMessageBox>
-#include <QTableWidgetItem>
 #include <QVariant>
 
 #include "core/experimentsmgr.h"
@@ -55,17 +54,16 @@ ProjectWidget::ProjectWidget(ProjectPtr project, MainGUI* mainGUI, ProjectsPage*
 
     m_ui->labelExps->setFont(FontStyles::subtitle2());
 
-    connect(m_project.get(), SIGNAL(expAdded(int)), SLOT(slotInsertRow(int)));
-    connect(m_project.get(), SIGNAL(expEdited(int)), SLOT(slotUpdateRow(int)));
-    connect(m_project.get(), SIGNAL(expRemoved(int)), SLOT(slotRemoveRow(int)));
     connect(m_project.get(), SIGNAL(hasUnsavedChanges(bool)),
             SLOT(slotHasUnsavedChanges(bool)));
 
-    m_ui->table->init(mainGUI->mainApp()->expMgr());
+    // the table keeps itself in sync with the experiments of the project
+    m_ui->table->init(mainGUI->mainApp()->expMgr(), m_project);
 
-    connect(m_ui->table, SIGNAL(itemSelectionChanged()), SLOT(slotSelectionChanged()));
-    connect(m_ui->table, SIGNAL(itemDoubleClicked(QTableWidgetItem*)),
-            SLOT(onItemDoubleClicked(QTableWidgetItem*)));
+    connect(m_ui->table->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
+            SLOT(slotSelectionChanged()));
+    connect(m_ui->table, SIGNAL(doubleClicked(QModelIndex)),
+            SLOT(onItemDoubleClicked(QModelIndex)));
 
     QSettings userPrefs;
     auto _visibleCols = QVariant::fromValue<QVariantList>({TableWidget::H_BUTTON,
@@ -145,99 +143,19 @@ void ProjectWidget::closeEvent(QCloseEvent* event)
     QDockWidget::closeEvent(event);
 }
 
-void ProjectWidget::fillRow(int row, const ExperimentPtr& exp)
-{
-    Q_ASSERT(exp && exp->inputs());
-
-    m_ui->table->setSortingEnabled(false);
-
-    // general stuff
-    insertItem(row, TableWidget::H_EXPID, QString::number(exp->id()));
-    insertItem(row, TableWidget::H_SEED, exp->inputs()->general(GENERAL_ATTR_SEED).toQString());
-    insertItem(row, TableWidget::H_STOPAT, exp->inputs()->general(GENERAL_ATTR_STOPAT).toQString());
-    insertItem(row, TableWidget::H_TRIALS, exp->inputs()->general(GENERAL_ATTR_TRIALS).toQString());
-
-    if (exp->expStatus() == Status::Invalid) {
-        m_ui->table->setSortingEnabled(true);
-        return;
-    }
-
-    // lambda function to add the attributes of a plugin (ie, model or graph)
-    auto pluginAtbs = [this, row](TableWidget::Header header, const QString& pluginId, const Attributes* attrs)
-    {
-        QString pluginAttrs = pluginId;
-        for (const Value& v : attrs->values()) {
-            pluginAttrs += QString(" | %1").arg(v.toQString());
-        }
-        QTableWidgetItem* item = new QTableWidgetItem(pluginAttrs);
-        item->setTextAlignment(Qt::AlignCenter);
-        item->setToolTip(pluginAttrs);
-        //QFont font = item->font();
-        //font.setItalic(true);
-        //item->setFont(font);
-        m_ui->table->setItem(row, header, item);
-    };
-
-    // model stuff
-    pluginAtbs(TableWidget::H_MODEL, exp->modelId(), exp->inputs()->model());
-
-    // graph stuff
-    pluginAtbs(TableWidget::H_GRAPH, exp->graphId(), exp->inputs()->graph());
-
-    m_ui->table->setSortingEnabled(true);
-}
-
-void ProjectWidget::slotInsertRow(int expId)
-{
-    ExperimentPtr exp = m_project->experiment(expId);
-    fillRow(m_ui->table->insertRow(exp.get()), exp);
-}
-
-void ProjectWidget::slotUpdateRow(int expId)
-{
-    for (int row = 0; row < m_ui->table->rowCount(); ++row) {
-        if (expId == m_ui->table->item(row, TableWidget::H_EXPID)->text().toInt()) {
-            fillRow(row, m_project->experiment(expId));
-            return;
-        }
-    }
-    qFatal("failed to update row! It should never happen.");
-}
-
-void ProjectWidget::slotRemoveRow(int expId)
-{
-    for (int row = 0; row < m_ui->table->rowCount(); ++row) {
-        if (expId == m_ui->table->item(row, TableWidget::H_EXPID)->text().toInt()) {
-            m_ui->table->removeRow(row);
-            return;
-        }
-    }
-}
-
-void ProjectWidget::insertItem(int row, TableWidget::Header header,
-                               const QString& label, const QString& tooltip)
-{
-    QTableWidgetItem* item = new QTableWidgetItem(label);
-    item->setTextAlignment(Qt::AlignCenter);
-    item->setToolTip(tooltip);
-    m_ui->table->setItem(row, header, item);
-}
-
 void ProjectWidget::slotSelectionChanged()
 {
-    if (m_ui->table->selectedItems().isEmpty()) {
-        emit (expSelectionChanged(-1));
-    } else {
-        const int row = m_ui->table->selectedItems().first()->row();
-        const int expId = m_ui->table->item(row, TableWidget::H_EXPID)->text().toInt();
-        emit (expSelectionChanged(expId));
-    }
+    const QModelIndexList rows = m_ui->table->selectionModel()->selectedRows();
+    const Experiment* exp = rows.isEmpty() ? nullptr : m_ui->table->experiment(rows.first());
+    emit (expSelectionChanged(exp ? exp->id() : -1));
 }
 
-void ProjectWidget::onItemDoubleClicked(QTableWidgetItem* item)
+void ProjectWidget::onItemDoubleClicked(const QModelIndex& index)
 {
-    int expId = m_ui->table->item(item->row(), TableWidget::H_EXPID)->text().toInt();
-    emit (openExperiment(expId));
+    const Experiment* exp = m_ui->table->experiment(index);
+    if (exp) {
+        emit (openExperiment(exp->id()));
+    }
 }
 
 void ProjectWidget::slotHasUnsavedChanges(bool b)
@@ -59,24 +59,16 @@ signals:
     void hasUnsavedChanges(int projId);
 
 public slots:
-    void slotInsertRow(int expId);
-    void slotUpdateRow(int expId);
-    void slotRemoveRow(int expId);
     void slotHasUnsavedChanges(bool b);
 
 private slots:
     void slotSelectionChanged();
-    void onItemDoubleClicked(QTableWidgetItem* item);
+    void onItemDoubleClicked(const QModelIndex& index);
 
 private:
     Ui_ProjectWidget* m_ui;
     MainGUI* m_mainGUI;
     ProjectPtr m_project;
-
-    void fillRow(int row, const ExperimentPtr& exp);
-
-    void insertItem(int row, TableWidget::Header header,
-                    const QString& label, const QString& tooltip="");
 };
 }
 #endif // PROJECTWIDGET_H
@@ -0,0 +1,118 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include "seriesbuffer.h"
+
+namespace evoplex {
+
+SeriesBuffer::SeriesBuffer(int maxBuckets)
+    : m_maxBuckets(static_cast<size_t>(qMax(2, maxBuckets))),
+      m_x0(0.),
+      m_width(1.)
+{
+    m_buckets.reserve(m_maxBuckets);
+}
+
+void SeriesBuffer::clear()
+{
+    m_buckets.clear();
+    m_x0 = 0.;
+    m_width = 1.;
+}
+
+void SeriesBuffer::append(const QPointF& p)
+{
+    if (m_buckets.empty()) {
+        m_x0 = p.x();
+    }
+
+    qint64 index = static_cast<qint64>(std::floor((p.x() - m_x0) / m_width));
+    if (!m_buckets.empty()) {
+        Bucket& b = m_buckets.back();
+        // an out-of-order point is just added to the last bucket
+        if (index <= b.index) {
+            b.last = p;
+            if (p.y() < b.min.y()) { b.min = p; }
+            if (p.y() > b.max.y()) { b.max = p; }
+            return;
+        }
+    }
+
+    if (m_buckets.size() >= m_maxBuckets) {
+        // a single merge might not reduce the number of buckets, e.g., when
+        // the points are farther apart than the width (outputInterval > 1)
+        while (m_buckets.size() >= m_maxBuckets) {
+            mergeBuckets();
+        }
+        index = static_cast<qint64>(std::floor((p.x() - m_x0) / m_width));
+        if (index <= m_buckets.back().index) {
+            append(p);
+            return;
+        }
+    }
+    m_buckets.push_back({index, p, p, p, p});
+}
+
+void SeriesBuffer::mergeBuckets()
+{
+    m_width *= 2.;
+    size_t n = 0;
+    for (const Bucket& b : m_buckets) {
+        const qint64 index = b.index / 2;
+        if (n > 0 && m_buckets[n - 1].index == index) {
+            Bucket& prev = m_buckets[n - 1];
+            prev.last = b.last;
+            if (b.min.y() < prev.min.y()) { prev.min = b.min; }
+            if (b.max.y() > prev.max.y()) { prev.max = b.max; }
+        } else {
+            m_buckets[n] = b;
+            m_buckets[n].index = index;
+            ++n;
+        }
+    }
+    m_buckets.resize(n);
+}
+
+QVector<QPointF> SeriesBuffer::points() const
+{
+    QVector<QPointF> points;
+    points.reserve(static_cast<int>(m_buckets.size() * 4));
+    auto add = [&points](const QPointF& p) {
+        if (points.isEmpty() || points.last() != p) {
+            points.push_back(p);
+        }
+    };
+    for (const Bucket& b : m_buckets) {
+        add(b.first);
+        if (b.min.x() <= b.max.x()) {
+            add(b.min);
+            add(b.max);
+        } else {
+            add(b.max);
+            add(b.min);
+        }
+        add(b.last);
+    }
+    return points;
+}
+
+} // evoplex
@@ -0,0 +1,73 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERIESBUFFER_H
+#define SERIESBUFFER_H
+
+#include <vector>
+#include <QPointF>
+#include <QVector>
+
+namespace evoplex {
+
+/**
+ * @brief A bounded, multi-resolution buffer of the points of a line series.
+ *
+ * The x-axis is split into at most 'maxBuckets' buckets of the same width,
+ * and each bucket keeps only its first, last, min and max points, which is
+ * all we need to draw the line at that resolution. When the buckets are
+ * full, each two neighbour buckets are merged, i.e., the width doubles.
+ * Thus, appending a point is amortised O(1) and a series of any length is
+ * drawn with at most 4*maxBuckets points.
+ */
+class SeriesBuffer
+{
+public:
+    explicit SeriesBuffer(int maxBuckets = 1024);
+
+    // the points are expected in non-decreasing order of x
+    void append(const QPointF& p);
+    void clear();
+
+    inline bool isEmpty() const { return m_buckets.empty(); }
+    inline qreal bucketWidth() const { return m_width; }
+
+    // The points to be drawn, in order of x.
+    QVector<QPointF> points() const;
+
+private:
+    struct Bucket {
+        qint64 index;
+        QPointF first;
+        QPointF last;
+        QPointF min;
+        QPointF max;
+    };
+
+    const size_t m_maxBuckets;
+    std::vector<Bucket> m_buckets;
+    qreal m_x0;    // x of the first point
+    qreal m_width; // in units of x
+
+    void mergeBuckets();
+};
+
+} // evoplex
+#endif // SERIESBUFFER_H
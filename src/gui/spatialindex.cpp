@@ -0,0 +1,117 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+
+#include "spatialindex.h"
+
+namespace evoplex {
+
+SpatialIndex::SpatialIndex()
+    : m_cols(0),
+      m_rows(0),
+      m_cellWidth(1.),
+      m_cellHeight(1.)
+{
+}
+
+void SpatialIndex::clear()
+{
+    m_bounds = QRectF();
+    m_cols = 0;
+    m_rows = 0;
+    m_offsets.clear();
+    m_offsets.shrink_to_fit();
+    m_entries.clear();
+    m_entries.shrink_to_fit();
+}
+
+void SpatialIndex::build(const Nodes& nodes)
+{
+    clear();
+    if (nodes.empty()) {
+        return;
+    }
+
+    qreal left = nodes.cbegin()->second.x();
+    qreal top = nodes.cbegin()->second.y();
+    qreal right = left;
+    qreal bottom = top;
+    for (auto const& np : nodes) {
+        const qreal x = np.second.x();
+        const qreal y = np.second.y();
+        left = qMin(left, x);
+        right = qMax(right, x);
+        top = qMin(top, y);
+        bottom = qMax(bottom, y);
+    }
+    m_bounds = QRectF(QPointF(left, top), QPointF(right, bottom));
+
+    // about four nodes per bucket, keeping the buckets roughly square
+    const qreal numBuckets = qMax(1., std::ceil(nodes.size() / 4.));
+    const qreal w = qMax(m_bounds.width(), 1e-9);
+    const qreal h = qMax(m_bounds.height(), 1e-9);
+    const qreal maxSide = 1 << 14;
+    m_cols = static_cast<int>(qBound(1., std::round(std::sqrt(numBuckets * w / h)), maxSide));
+    m_rows = static_cast<int>(qBound(1., std::ceil(numBuckets / m_cols), maxSide));
+    m_cellWidth = w / m_cols;
+    m_cellHeight = h / m_rows;
+
+    // counting sort of the nodes by bucket
+    const size_t buckets = static_cast<size_t>(m_cols) * static_cast<size_t>(m_rows);
+    m_offsets.assign(buckets + 1, 0);
+    std::vector<int> bucketOf;
+    bucketOf.reserve(nodes.size());
+    for (auto const& np : nodes) {
+        const int b = row(np.second.y()) * m_cols + col(np.second.x());
+        bucketOf.emplace_back(b);
+        ++m_offsets[static_cast<size_t>(b) + 1];
+    }
+    for (size_t b = 0; b < buckets; ++b) {
+        m_offsets[b + 1] += m_offsets[b];
+    }
+
+    std::vector<int> next(m_offsets.begin(), m_offsets.end() - 1);
+    m_entries.resize(nodes.size());
+    size_t i = 0;
+    for (auto const& np : nodes) {
+        const size_t pos = static_cast<size_t>(next[static_cast<size_t>(bucketOf[i++])]++);
+        m_entries[pos].xy = QPointF(np.second.x(), np.second.y());
+        m_entries[pos].node = np.second;
+    }
+}
+
+Node SpatialIndex::nodeAt(const QPointF& p, qreal radius) const
+{
+    Node closest;
+    qreal minDist = 0.;
+    forEachIn(QRectF(p.x() - radius, p.y() - radius, 2. * radius, 2. * radius),
+              [&closest, &minDist, &p](const Node& node, const QPointF& xy) {
+        const QPointF d = xy - p;
+        const qreal dist = QPointF::dotProduct(d, d);
+        if (closest.isNull() || dist < minDist) {
+            closest = node;
+            minDist = dist;
+        }
+    });
+    return closest;
+}
+
+} // evoplex
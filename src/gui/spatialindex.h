@@ -0,0 +1,120 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <vector>
+#include <QPointF>
+#include <QRectF>
+
+#include "core/include/nodes.h"
+
+namespace evoplex {
+
+/**
+ * @brief A uniform grid over the nodes' coordinates.
+ *
+ * The nodes are bucketed by their coordinates, with about four nodes per
+ * bucket, and stored contiguously bucket by bucket. Thus, a viewport query
+ * only visits the buckets it overlaps, i.e., O(visible nodes), and picking
+ * a node visits just a few buckets.
+ *
+ * It's a snapshot of the coordinates; it must be rebuilt if they change.
+ */
+class SpatialIndex
+{
+public:
+    SpatialIndex();
+
+    void build(const Nodes& nodes);
+    void clear();
+
+    inline size_t size() const { return m_entries.size(); }
+    inline bool isEmpty() const { return m_entries.empty(); }
+
+    // the bounding box of the nodes' coordinates
+    inline const QRectF& bounds() const { return m_bounds; }
+
+    // Calls func(const Node&, const QPointF&) for each node inside 'rect'.
+    template<typename Func>
+    void forEachIn(const QRectF& rect, Func func) const;
+
+    // Returns the closest node to 'p' which is at most 'radius' away from it
+    // in both axes, or a null Node if there is none.
+    Node nodeAt(const QPointF& p, qreal radius) const;
+
+private:
+    struct Entry {
+        QPointF xy;
+        Node node;
+    };
+
+    QRectF m_bounds;
+    int m_cols;
+    int m_rows;
+    qreal m_cellWidth;
+    qreal m_cellHeight;
+    std::vector<int> m_offsets;   // entries of bucket 'b' are in [m_offsets[b], m_offsets[b+1])
+    std::vector<Entry> m_entries; // sorted by bucket
+
+    inline int col(qreal x) const;
+    inline int row(qreal y) const;
+};
+
+inline int SpatialIndex::col(qreal x) const
+{
+    const qreal c = (x - m_bounds.left()) / m_cellWidth;
+    return static_cast<int>(qBound(0., c, m_cols - 1.));
+}
+
+inline int SpatialIndex::row(qreal y) const
+{
+    const qreal r = (y - m_bounds.top()) / m_cellHeight;
+    return static_cast<int>(qBound(0., r, m_rows - 1.));
+}
+
+template<typename Func>
+void SpatialIndex::forEachIn(const QRectF& rect, Func func) const
+{
+    if (m_entries.empty() || rect.right() < m_bounds.left() || rect.left() > m_bounds.right()
+            || rect.bottom() < m_bounds.top() || rect.top() > m_bounds.bottom()) {
+        return;
+    }
+
+    const int c0 = col(rect.left());
+    const int c1 = col(rect.right());
+    const int r1 = row(rect.bottom());
+    for (int r = row(rect.top()); r <= r1; ++r) {
+        // the buckets of a row are contiguous
+        const size_t begin = static_cast<size_t>(m_offsets[r * m_cols + c0]);
+        const size_t end = static_cast<size_t>(m_offsets[r * m_cols + c1 + 1]);
+        for (size_t i = begin; i < end; ++i) {
+            const Entry& e = m_entries[i];
+            if (e.xy.x() >= rect.left() && e.xy.x() <= rect.right() &&
+                    e.xy.y() >= rect.top() && e.xy.y() <= rect.bottom()) {
+                func(e.node, e.xy);
+            }
+        }
+    }
+}
+
+} // evoplex
+#endif // SPATIALINDEX_H
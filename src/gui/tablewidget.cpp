@@ -23,13 +23,20 @@
 #include <QPaintEvent>
 #include <QPixmap>
 #include <QDebug>
+#include <algorithm>
 
 #include "tablewidget.h"
 
 namespace evoplex {
 
+namespace {
+// the numbers are kept as such, so they are sorted as numbers
+QVariant toVariant(const Value& v)
+{ return v.isInt() ? QVariant(v.toInt()) : QVariant(v.toQString()); }
+}
+
 TableWidget::TableWidget(QWidget *parent)
-    : QTableWidget(parent),
+    : QTableView(parent),
       kIcon_check(QPixmap(":/icons/check.svg").scaledToWidth(14, Qt::SmoothTransformation)),
       kIcon_play(QPixmap(":/icons/play-circle.svg").scaledToWidth(28, Qt::SmoothTransformation)),
       kIcon_playon(QPixmap(":/icons/play-circle-on.svg").scaledToWidth(28, Qt::SmoothTransformation)),
@@ -38,7 +45,9 @@ TableWidget::TableWidget(QWidget *parent)
       kIcon_x(QPixmap(":/icons/x.svg").scaledToWidth(14, Qt::SmoothTransformation)),
       kPen_circleon(QBrush(QColor(66,133,244)), 3),
       kPen_circle(QBrush(QColor(80,80,80)), 3),
-      m_expMgr(nullptr)
+      m_expMgr(nullptr),
+      m_model(nullptr),
+      m_proxy(new QSortFilterProxyModel(this))
 {
     setMouseTracking(true);
 
@@ -66,30 +75,23 @@ TableWidget::TableWidget(QWidget *parent)
     m_headerLabel.insert(H_GRAPH, "Graph");
     m_headerLabel.insert(H_TRIALS, "Trials");
 
-    setColumnCount(m_headerLabel.size());
-    setHorizontalHeaderLabels(m_headerLabel.values());
     setShowGrid(false);
-    setSortingEnabled(true);
     setEditTriggers(QAbstractItemView::NoEditTriggers);
     setSelectionBehavior(QAbstractItemView::SelectRows);
     setSelectionMode(QAbstractItemView::SingleSelection);
 
     horizontalHeader()->setHighlightSections(false);
     horizontalHeader()->setStretchLastSection(true);
-    horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
-    horizontalHeader()->setSectionResizeMode(H_EXPID, QHeaderView::ResizeToContents);
-    horizontalHeader()->setSectionResizeMode(H_SEED, QHeaderView::ResizeToContents);
-    horizontalHeader()->setSectionResizeMode(H_STOPAT, QHeaderView::ResizeToContents);
-    horizontalHeader()->setSectionResizeMode(H_TRIALS, QHeaderView::ResizeToContents);
-    horizontalHeader()->setSectionResizeMode(H_MODEL, QHeaderView::Stretch);
-    horizontalHeader()->setSectionResizeMode(H_GRAPH, QHeaderView::Stretch);
+    horizontalHeader()->setDefaultSectionSize(60);
 
     verticalHeader()->setVisible(false);
     verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     verticalHeader()->setDefaultSectionSize(40);
 
-    connect(this, SIGNAL(itemClicked(QTableWidgetItem*)),
-            SLOT(onItemClicked(QTableWidgetItem*)));
+    // a single delegate for all rows
+    setItemDelegate(new RowsDelegate(this));
+
+    connect(this, SIGNAL(clicked(QModelIndex)), SLOT(onItemClicked(QModelIndex)));
 
     // setup the context menu
 //    m_contextMenu = new ContextMenuTable(m_project, m_tableExps);
@@ -99,78 +101,241 @@ TableWidget::TableWidget(QWidget *parent)
 //    connect(m_contextMenu, SIGNAL(openView(int)), this, SLOT(slotOpenView(int)));
 }
 
-void TableWidget::init(ExperimentsMgr* expMgr)
+void TableWidget::init(ExperimentsMgr* expMgr, ProjectPtr project)
 {
     m_expMgr = expMgr;
-    connect(m_expMgr, SIGNAL(progressUpdated()), viewport(), SLOT(update()));
+    m_model = new ExperimentsModel(project, m_headerLabel.values(), this);
+    m_proxy->setSourceModel(m_model);
+    setModel(m_proxy);
+    setSortingEnabled(true);
+    sortByColumn(H_EXPID, Qt::AscendingOrder);
+
+    // the sections exist only after setting the model
+    horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    horizontalHeader()->setSectionResizeMode(H_BUTTON, QHeaderView::Fixed);
+    horizontalHeader()->setSectionResizeMode(H_EXPID, QHeaderView::ResizeToContents);
+    horizontalHeader()->setSectionResizeMode(H_SEED, QHeaderView::ResizeToContents);
+    horizontalHeader()->setSectionResizeMode(H_STOPAT, QHeaderView::ResizeToContents);
+    horizontalHeader()->setSectionResizeMode(H_TRIALS, QHeaderView::ResizeToContents);
+    horizontalHeader()->setSectionResizeMode(H_MODEL, QHeaderView::Stretch);
+    horizontalHeader()->setSectionResizeMode(H_GRAPH, QHeaderView::Stretch);
+
+    connect(m_expMgr, SIGNAL(progressUpdated()), m_model, SLOT(updateDirtyRows()));
 }
 
-int TableWidget::insertRow(Experiment* exp)
+Experiment* TableWidget::experiment(const QModelIndex& index) const
 {
-    Q_ASSERT_X(m_expMgr, "TableWidget", "table must be initialized first");
+    if (!m_model || !index.isValid()) {
+        return nullptr;
+    }
+    return m_model->experiment(m_proxy->mapToSource(index).row());
+}
 
-    int row = rowCount();
-    QTableWidget::insertRow(row);
+void TableWidget::onItemClicked(const QModelIndex& index)
+{
+    if (index.column() != H_BUTTON)
+        return; // it's not the button
 
-    // to make the toggle button work properly,
-    // we need to attach the Experiment* to it
-    QTableWidgetItem* item = new QTableWidgetItem("");
-    item->setData(Qt::UserRole, QVariant::fromValue(exp));
-    setItem(row, 0, item); // always in the first column
+    Experiment* exp = experiment(index);
+    if (exp) exp->toggle();
+}
 
-    horizontalHeader()->setDefaultSectionSize(60);
-    horizontalHeader()->setSectionResizeMode(H_BUTTON, QHeaderView::Fixed);
+/*********************************************************/
+/*********************************************************/
 
-    setItemDelegateForRow(row, new RowsDelegate(exp, this));
+ExperimentsModel::ExperimentsModel(ProjectPtr project, const QStringList& headerLabels,
+                                   QObject* parent)
+    : QAbstractTableModel(parent),
+      m_project(project),
+      m_headerLabels(headerLabels)
+{
+    m_exps.reserve(m_project->experiments().size());
+    for (auto const& it : m_project->experiments()) {
+        m_exps.emplace_back(it.second.get());
+        watch(it.second.get());
+    }
 
-    return row;
+    connect(m_project.get(), SIGNAL(expAdded(int)), SLOT(insertExperiment(int)));
+    connect(m_project.get(), SIGNAL(expEdited(int)), SLOT(updateExperiment(int)));
+    connect(m_project.get(), SIGNAL(expRemoved(int)), SLOT(removeExperiment(int)));
 }
 
-void TableWidget::onItemClicked(QTableWidgetItem* item)
+int ExperimentsModel::rowCount(const QModelIndex& parent) const
+{ return parent.isValid() ? 0 : static_cast<int>(m_exps.size()); }
+
+int ExperimentsModel::columnCount(const QModelIndex& parent) const
+{ return parent.isValid() ? 0 : m_headerLabels.size(); }
+
+QVariant ExperimentsModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
-    if (!item || item->column() != 0)
-        return; // it's not the button
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        return m_headerLabels.value(section);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
 
-    auto exp = item->data(Qt::UserRole).value<Experiment*>();
-    if (exp) exp->toggle();
+Experiment* ExperimentsModel::experiment(int row) const
+{
+    return row >= 0 && row < rowCount() ? m_exps[static_cast<size_t>(row)] : nullptr;
 }
 
-void TableWidget::removeRow(int row)
+int ExperimentsModel::row(int expId) const
 {
-    // Item delegates are not updated automatically.
-    // For example, when we remove the row 2, the row 3 will become the row 2
-    // but will continue to use the delegate of the removed row 2. So, we need
-    // to reassign all delegates below the removed row.
-    const int lastRow = rowCount() - 1;
-    for (int r = row; r < lastRow; ++r) {
-        setItemDelegateForRow(r, itemDelegateForRow(r+1));
+    auto it = std::lower_bound(m_exps.cbegin(), m_exps.cend(), expId,
+            [](const Experiment* exp, int id) { return exp->id() < id; });
+    if (it == m_exps.cend() || (*it)->id() != expId) {
+        return -1;
     }
-    setItemDelegateForRow(lastRow, nullptr);
-    model()->removeRow(row);
+    return static_cast<int>(it - m_exps.cbegin());
+}
+
+QVariant ExperimentsModel::data(const QModelIndex& index, int role) const
+{
+    Experiment* exp = experiment(index.row());
+    if (!exp) {
+        return QVariant();
+    }
+
+    if (role == Qt::UserRole) {
+        // to make the toggle button work properly,
+        // we need to attach the Experiment* to it
+        return QVariant::fromValue(exp);
+    } else if (role == Qt::TextAlignmentRole) {
+        return static_cast<int>(Qt::AlignCenter);
+    } else if (role != Qt::DisplayRole && role != Qt::ToolTipRole) {
+        return QVariant();
+    }
+
+    const ExpInputs* inputs = exp->inputs();
+    if (!inputs) {
+        return QVariant();
+    }
+
+    // the attributes of a plugin (ie, model or graph)
+    auto pluginAttrs = [exp](const QString& pluginId, const Attributes* attrs) {
+        if (exp->expStatus() == Status::Invalid) {
+            return QVariant();
+        }
+        QString str = pluginId;
+        for (const Value& v : attrs->values()) {
+            str += QString(" | %1").arg(v.toQString());
+        }
+        return QVariant(str);
+    };
+
+    switch (static_cast<TableWidget::Header>(index.column())) {
+    case TableWidget::H_MODEL:
+        return pluginAttrs(exp->modelId(), inputs->model());
+    case TableWidget::H_GRAPH:
+        return pluginAttrs(exp->graphId(), inputs->graph());
+    default:
+        break;
+    }
+
+    if (role == Qt::ToolTipRole) {
+        return QVariant();
+    }
+
+    switch (static_cast<TableWidget::Header>(index.column())) {
+    case TableWidget::H_EXPID:
+        return exp->id();
+    case TableWidget::H_SEED:
+        return toVariant(inputs->general(GENERAL_ATTR_SEED));
+    case TableWidget::H_STOPAT:
+        return toVariant(inputs->general(GENERAL_ATTR_STOPAT));
+    case TableWidget::H_TRIALS:
+        return toVariant(inputs->general(GENERAL_ATTR_TRIALS));
+    default:
+        return QVariant();
+    }
+}
+
+void ExperimentsModel::insertExperiment(int expId)
+{
+    ExperimentPtr exp = m_project->experiment(expId);
+    if (!exp) {
+        return;
+    }
+
+    // the new ids are usually the largest ones, i.e., it's an append
+    auto it = std::lower_bound(m_exps.begin(), m_exps.end(), expId,
+            [](const Experiment* e, int id) { return e->id() < id; });
+    const int r = static_cast<int>(it - m_exps.begin());
+    beginInsertRows(QModelIndex(), r, r);
+    m_exps.insert(it, exp.get());
+    endInsertRows();
+    watch(exp.get());
+}
+
+void ExperimentsModel::updateExperiment(int expId)
+{
+    const int r = row(expId);
+    if (r >= 0) {
+        emit (dataChanged(index(r, 0), index(r, columnCount() - 1)));
+    }
+}
+
+void ExperimentsModel::removeExperiment(int expId)
+{
+    const int r = row(expId);
+    if (r < 0) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), r, r);
+    m_exps.erase(m_exps.begin() + r);
+    endRemoveRows();
+    m_dirtyExps.remove(expId);
+}
+
+void ExperimentsModel::watch(Experiment* exp)
+{
+    const int expId = exp->id();
+    // the progress is repainted in the next tick; the status right away
+    connect(exp, &Experiment::progressUpdated, this,
+            [this, expId]() { m_dirtyExps.insert(expId); });
+    connect(exp, &Experiment::statusChanged, this,
+            [this, expId]() { updateButton(expId); });
+}
+
+void ExperimentsModel::updateButton(int expId)
+{
+    const int r = row(expId);
+    if (r >= 0) {
+        const QModelIndex i = index(r, TableWidget::H_BUTTON);
+        emit (dataChanged(i, i));
+    }
+}
+
+void ExperimentsModel::updateDirtyRows()
+{
+    for (int expId : m_dirtyExps) {
+        updateButton(expId);
+    }
+    m_dirtyExps.clear();
 }
 
 /*********************************************************/
 /*********************************************************/
 
-RowsDelegate::RowsDelegate(Experiment* exp, TableWidget* table)
+RowsDelegate::RowsDelegate(TableWidget* table)
     : QStyledItemDelegate(table),
       m_table(table),
       m_hoveredRow(-1),
-      m_hoveredCol(-1),
-      m_status(exp->expStatus()),
-      m_progress(exp->progress())
+      m_hoveredCol(-1)
 {
-    connect(m_table, &QTableWidget::viewportEntered,
-        [this]() { m_hoveredRow = -1; m_hoveredCol = -1; });
-
-    connect(m_table, &QTableWidget::cellEntered,
-        [this](int row, int col) { m_hoveredRow = row; m_hoveredCol = col; });
-
-    connect(exp, &Experiment::statusChanged,
-        [this](Status s) { m_status = s; });
-
-    connect(exp, &Experiment::progressUpdated,
-        [this](quint16 p) { m_progress = p; });
+    connect(m_table, &QTableView::viewportEntered, [this]() {
+        m_hoveredRow = -1;
+        m_hoveredCol = -1;
+        m_table->viewport()->update();
+    });
+
+    connect(m_table, &QTableView::entered, [this](const QModelIndex& index) {
+        if (index.row() != m_hoveredRow) {
+            m_table->viewport()->update(); // highlights the entire row
+        }
+        m_hoveredRow = index.row();
+        m_hoveredCol = index.column();
+    });
 }
 
 RowsDelegate::~RowsDelegate()
@@ -206,6 +371,13 @@ void RowsDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
         return;
     }
 
+    const Experiment* exp = index.data(Qt::UserRole).value<Experiment*>();
+    if (!exp) {
+        return;
+    }
+    const Status status = exp->expStatus();
+    const quint16 progress = exp->progress();
+
     //
     // draw the toggle button in the first column
     //
@@ -218,7 +390,7 @@ void RowsDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
     center.rx() -= 7;
     center.ry() -= 7;
 
-    if (m_status == Status::Paused || m_status == Status::Disabled) {
+    if (status == Status::Paused || status == Status::Disabled) {
         center.rx() -= 7;
         center.ry() -= 7;
         if (btnIsHovered) { //play (only when hovered)
@@ -226,10 +398,10 @@ void RowsDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
         } else if (rowIsHovered) {
             painter->drawPixmap(center, m_table->kIcon_play);
         }
-        if (m_progress > 0) { // show progress
-            drawProgress(painter, center);
+        if (progress > 0) { // show progress
+            drawProgress(painter, center, progress);
         }
-    } else if (m_status == Status::Running || m_status == Status::Queued) {
+    } else if (status == Status::Running || status == Status::Queued) {
         center.rx() -= 7;
         center.ry() -= 7;
         if (btnIsHovered || rowIsHovered) { // pause (always show)
@@ -237,10 +409,10 @@ void RowsDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
         } else {
             painter->drawPixmap(center, m_table->kIcon_pause);
         }
-        if (m_progress > 0) { // show progress
-            drawProgress(painter, center);
+        if (progress > 0) { // show progress
+            drawProgress(painter, center, progress);
         }
-    } else if (m_status == Status::Finished) { // check (always)
+    } else if (status == Status::Finished) { // check (always)
         painter->drawPixmap(center, m_table->kIcon_check);
     } else {
         painter->drawPixmap(center, m_table->kIcon_x);
@@ -248,12 +420,12 @@ void RowsDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
     painter->restore();
 }
 
-void RowsDelegate::drawProgress(QPainter* painter, const QPointF& c) const
+void RowsDelegate::drawProgress(QPainter* painter, const QPointF& c, quint16 progress) const
 {
     painter->setPen(m_table->kPen_circleon);
     QRectF center(c.x(), c.y(), 28, 28);
     const int start = 1440; // 90*16
-    const int angle = (m_progress+1)*16;
+    const int angle = (progress+1)*16;
     painter->drawArc(center, start, -angle);
     painter->setPen(m_table->kPen_circle);
     painter->drawArc(center, start, 5760-angle); // 5760 = full circle
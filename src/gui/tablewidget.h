@@ -21,19 +21,25 @@
 #ifndef TABLEWIDGET_H
 #define TABLEWIDGET_H
 
+#include <QAbstractTableModel>
 #include <QPen>
+#include <QSet>
+#include <QSortFilterProxyModel>
 #include <QStyledItemDelegate>
-#include <QTableWidget>
+#include <QTableView>
 #include <QWidget>
+#include <vector>
 
 #include "core/experiment.h"
 #include "core/experimentsmgr.h"
+#include "core/project.h"
 
 namespace evoplex {
 
+class ExperimentsModel;
 class RowsDelegate;
 
-class TableWidget : public QTableWidget
+class TableWidget : public QTableView
 {
     Q_OBJECT
 
@@ -53,17 +59,15 @@ public:
     explicit TableWidget(QWidget* parent);
     ~TableWidget() {}
 
-    void init(ExperimentsMgr* expMgr);
+    void init(ExperimentsMgr* expMgr, ProjectPtr project);
 
-    int insertRow(Experiment* exp);
+    // the experiment in the row of 'index', or nullptr
+    Experiment* experiment(const QModelIndex& index) const;
 
     inline const QMap<Header, QString>& headerLabels() const;
 
-public slots:
-    void removeRow(int row);
-
 private slots:
-    void onItemClicked(QTableWidgetItem* item);
+    void onItemClicked(const QModelIndex& index);
 
 private:
     const QPixmap kIcon_check;
@@ -76,18 +80,67 @@ private:
     const QPen kPen_circle;
 
     ExperimentsMgr* m_expMgr;
+    ExperimentsModel* m_model;
+    QSortFilterProxyModel* m_proxy; // sorts the rows without touching the model
 
     QMap<Header, QString> m_headerLabel; // map Header to column label
 };
 
 /*********************************************************/
 
+/**
+ * @brief The experiments of a project, one per row, in order of id.
+ *
+ * The cells are formatted only when the view asks for them, i.e., only the
+ * visible ones. The rows whose progress changed are collected and updated
+ * at once in the next tick of the ExperimentsMgr.
+ */
+class ExperimentsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit ExperimentsModel(ProjectPtr project, const QStringList& headerLabels,
+                              QObject* parent);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    Experiment* experiment(int row) const;
+
+    // the row of the experiment, or -1
+    int row(int expId) const;
+
+public slots:
+    // repaints the button of the experiments which made progress
+    void updateDirtyRows();
+
+private slots:
+    void insertExperiment(int expId);
+    void updateExperiment(int expId);
+    void removeExperiment(int expId);
+
+private:
+    ProjectPtr m_project;
+    const QStringList m_headerLabels;
+    std::vector<Experiment*> m_exps; // sorted by id, as in Project::experiments()
+    QSet<int> m_dirtyExps;
+
+    void watch(Experiment* exp);
+    void updateButton(int expId);
+};
+
+/*********************************************************/
+
 class RowsDelegate : public QStyledItemDelegate
 {
     Q_OBJECT
 
 public:
-    explicit RowsDelegate(Experiment* exp, TableWidget* table);
+    explicit RowsDelegate(TableWidget* table);
     ~RowsDelegate() override;
 
     void paint(QPainter *painter, const QStyleOptionViewItem &option,
@@ -97,10 +150,8 @@ private:
     TableWidget* m_table;
     int m_hoveredRow;
     int m_hoveredCol;
-    Status m_status;
-    quint16 m_progress;
 
-    void drawProgress(QPainter* painter, const QPointF& c) const;
+    void drawProgress(QPainter* painter, const QPointF& c, quint16 progress) const;
 };
 
 /*********************************************************/
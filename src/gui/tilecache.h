@@ -0,0 +1,151 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILECACHE_H
+#define TILECACHE_H
+
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+#include <QRectF>
+
+namespace evoplex {
+
+/**
+ * @brief Cached geometry of the views split into square tiles.
+ *
+ * The tiles are defined in the nodes' coordinates, thus they do not depend
+ * on the zoom level or on the position of the viewport. On pan, only the
+ * newly exposed tiles are built; on zoom, the cached tiles are just drawn
+ * at another scale. The tiles more than one tile away from the viewport
+ * are dropped, so the memory is bounded by what is on screen.
+ */
+template<typename Tile>
+class TileCache
+{
+public:
+    TileCache() : m_tileSize(0.) {}
+
+    void clear() { m_tiles.clear(); m_visible.clear(); }
+
+    // Side of the tiles in the nodes' coordinates.
+    // The cache is cleared if it changes.
+    inline qreal tileSize() const { return m_tileSize; }
+    void setTileSize(qreal size);
+
+    // the tiles overlapping the area passed to the last 'update()'
+    inline const std::vector<const Tile*>& visible() const { return m_visible; }
+    inline size_t size() const { return m_tiles.size(); }
+
+    // Makes the tiles overlapping 'area' (in the nodes' coordinates) the
+    // visible ones. Missing tiles are built with
+    // 'build(const QRectF& tileArea, Tile& tile)'.
+    // Returns the number of tiles built.
+    template<typename Build>
+    int update(const QRectF& area, Build build);
+
+    // the tile containing the point 'p' (in the nodes' coordinates),
+    // or nullptr if it's not cached
+    inline const Tile* tileAt(const QPointF& p) const;
+
+    // the area covered by the tile at column 'tx' and row 'ty'
+    inline QRectF tileArea(int tx, int ty) const
+    { return QRectF(tx * m_tileSize, ty * m_tileSize, m_tileSize, m_tileSize); }
+
+    // The tiles are half-open, i.e., a point on the right or bottom edges
+    // of a tile belongs to the next one.
+    static inline bool contains(const QRectF& tileArea, const QPointF& p)
+    { return p.x() >= tileArea.left() && p.x() < tileArea.right() &&
+             p.y() >= tileArea.top() && p.y() < tileArea.bottom(); }
+
+private:
+    qreal m_tileSize;
+    std::unordered_map<quint64, Tile> m_tiles; // <(column,row), tile>
+    std::vector<const Tile*> m_visible;
+
+    inline int tileOf(qreal v) const
+    { return static_cast<int>(qBound(-1e9, std::floor(v / m_tileSize), 1e9)); }
+
+    static inline quint64 key(int tx, int ty)
+    { return (static_cast<quint64>(static_cast<quint32>(tx)) << 32) | static_cast<quint32>(ty); }
+};
+
+template<typename Tile>
+void TileCache<Tile>::setTileSize(qreal size)
+{
+    if (!qFuzzyCompare(size, m_tileSize)) {
+        clear();
+        m_tileSize = size;
+    }
+}
+
+template<typename Tile>
+inline const Tile* TileCache<Tile>::tileAt(const QPointF& p) const
+{
+    if (m_tileSize <= 0.) {
+        return nullptr;
+    }
+    const auto it = m_tiles.find(key(tileOf(p.x()), tileOf(p.y())));
+    return it == m_tiles.cend() ? nullptr : &it->second;
+}
+
+template<typename Tile>
+template<typename Build>
+int TileCache<Tile>::update(const QRectF& area, Build build)
+{
+    m_visible.clear();
+    if (m_tileSize <= 0. || !area.isValid()) {
+        return 0;
+    }
+
+    const int tx0 = tileOf(area.left());
+    const int tx1 = tileOf(area.right());
+    const int ty0 = tileOf(area.top());
+    const int ty1 = tileOf(area.bottom());
+
+    // drop the tiles which are far from the area
+    auto it = m_tiles.begin();
+    while (it != m_tiles.end()) {
+        const int tx = static_cast<int>(static_cast<quint32>(it->first >> 32));
+        const int ty = static_cast<int>(static_cast<quint32>(it->first));
+        if (tx < tx0 - 1 || tx > tx1 + 1 || ty < ty0 - 1 || ty > ty1 + 1) {
+            it = m_tiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    int built = 0;
+    m_visible.reserve(static_cast<size_t>(tx1 - tx0 + 1) * static_cast<size_t>(ty1 - ty0 + 1));
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            auto res = m_tiles.insert({key(tx, ty), Tile()});
+            if (res.second) {
+                build(tileArea(tx, ty), res.first->second);
+                ++built;
+            }
+            m_visible.emplace_back(&res.first->second);
+        }
+    }
+    return built;
+}
+
+} // evoplex
+#endif // TILECACHE_H
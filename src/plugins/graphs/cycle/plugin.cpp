@@ -58,6 +58,11 @@ bool CycleGraph::reset()
     return true;
 }
 
+bool CycleGraph::hasRandomTopology() const
+{
+    return false;
+}
+
 void CycleGraph::fixCoords(Node n, double radius, double dTheta) const
 {
     n.setCoords(radius + radius * qCos(dTheta * n.id()),
@@ -29,6 +29,7 @@ class CycleGraph: public AbstractGraph
 public:
     bool init() override;
     bool reset() override;
+    bool hasRandomTopology() const override;
 
 private:
     void fixCoords(Node n, double radius, double dTheta) const;
@@ -67,6 +67,11 @@ bool EdgesFromCSV::reset()
     return true;
 }
 
+bool EdgesFromCSV::hasRandomTopology() const
+{
+    return false;
+}
+
 bool EdgesFromCSV::validateHeader(const QStringList& header) const
 {
     if (header.isEmpty()) {
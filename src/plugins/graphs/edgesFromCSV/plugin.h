@@ -32,6 +32,7 @@ class EdgesFromCSV: public AbstractGraph
 public:
     bool init() override;
     bool reset() override;
+    bool hasRandomTopology() const override;
 
 private:
     // graph parameters
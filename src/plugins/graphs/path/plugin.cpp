@@ -71,6 +71,11 @@ bool PathGraph::reset()
     return true;
 }
 
+bool PathGraph::hasRandomTopology() const
+{
+    return false;
+}
+
 } // evoplex
 REGISTER_PLUGIN(PathGraph)
 #include "plugin.moc"
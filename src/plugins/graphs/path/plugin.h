@@ -29,6 +29,7 @@ class PathGraph: public AbstractGraph
 public:
     bool init() override;
     bool reset() override;
+    bool hasRandomTopology() const override;
 
 private:
     enum Layout { Horizontal, Vertical, None };
@@ -51,6 +51,16 @@ bool SquareGrid::reset()
 {
     removeAllEdges();
 
+    for (Node node : m_nodes) {
+        int x, y;
+        ind2sub(node.id(), m_width, y, x);
+        node.setCoords(x, y);
+    }
+
+    if (hasImplicitEdges()) {
+        return true; // the neighbours are computed on the fly
+    }
+
     int numEdges = numNodes() * m_numNeighbours;
     edgesFunc func;
     if (isDirected()) {
@@ -67,24 +77,52 @@ bool SquareGrid::reset()
     }
 
     if (m_periodic) {
-        for (Node node : m_nodes) {
-            int x, y;
-            ind2sub(node.id(), m_width, y, x);
-            node.setCoords(x, y);
-            createPeriodicEdges(node.id(), func, soa, edgeId);
+        for (auto const& node : m_nodes) {
+            createPeriodicEdges(node.first, func, soa, edgeId);
         }
     } else {
-        for (Node node : m_nodes) {
-            int x, y;
-            ind2sub(node.id(), m_width, y, x);
-            node.setCoords(x, y);
-            createFixedEdges(node.id(), func, soa, edgeId);
+        for (auto const& node : m_nodes) {
+            createFixedEdges(node.first, func, soa, edgeId);
         }
     }
 
     return true;
 }
 
+bool SquareGrid::hasRandomTopology() const
+{
+    return false;
+}
+
+bool SquareGrid::supportsImplicitEdges() const
+{
+    return true;
+}
+
+void SquareGrid::neighbourIds(const int nodeId, std::vector<int>& ids) const
+{
+    // same order as in directed4Edges() and directed8Edges()
+    static const int offsets4[4][2] = { {-1,0}, {0,-1}, {0,1}, {1,0} };
+    static const int offsets8[8][2] = { {-1,-1}, {-1,0}, {-1,1}, {0,-1},
+                                        {0,1}, {1,-1}, {1,0}, {1,1} };
+    const int (*offsets)[2] = m_numNeighbours == 4 ? offsets4 : offsets8;
+
+    ids.clear();
+    int row, col;
+    ind2sub(nodeId, m_width, row, col);
+    for (int i = 0; i < m_numNeighbours; ++i) {
+        int r = row + offsets[i][0];
+        int c = col + offsets[i][1];
+        if (m_periodic) {
+            r = r < 0 ? m_height - 1 : (r >= m_height ? 0 : r);
+            c = c < 0 ? m_width - 1 : (c >= m_width ? 0 : c);
+        } else if (r < 0 || r >= m_height || c < 0 || c >= m_width) {
+            continue;
+        }
+        ids.emplace_back(linearIdx(r, c, m_width));
+    }
+}
+
 void SquareGrid::createPeriodicEdges(const int id, const edgesFunc& func,
                                      const SetOfAttributes& soa, int& edgeId)
 {
@@ -32,6 +32,11 @@ class SquareGrid: public AbstractGraph
 public:
     bool init() override;
     bool reset() override;
+    bool hasRandomTopology() const override;
+
+    // the neighbours are computed from the row and column of the node
+    bool supportsImplicitEdges() const override;
+    void neighbourIds(const int nodeId, std::vector<int>& ids) const override;
 
 private:
     bool m_periodic; // boundary conditions: false for fixed
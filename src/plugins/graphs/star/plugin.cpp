@@ -59,6 +59,11 @@ bool StarGraph::reset()
     return true;
 }
 
+bool StarGraph::hasRandomTopology() const
+{
+    return false;
+}
+
 void StarGraph::fixCoords(Node n, double radius, double dTheta) const
 {
     double t = dTheta * (n.id() - 1);
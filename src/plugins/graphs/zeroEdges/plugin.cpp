@@ -33,6 +33,11 @@ bool ZeroEdges::reset()
     return true;
 }
 
+bool ZeroEdges::hasRandomTopology() const
+{
+    return false;
+}
+
 } // evoplex
 REGISTER_PLUGIN(ZeroEdges)
 #include "plugin.moc"
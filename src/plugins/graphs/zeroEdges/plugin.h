@@ -29,6 +29,7 @@ class ZeroEdges: public AbstractGraph
 public:
     bool init() override;
     bool reset() override;
+    bool hasRandomTopology() const override;
 };
 
 } // evoplex
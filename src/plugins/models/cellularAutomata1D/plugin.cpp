@@ -33,38 +33,96 @@ bool CellularAutomata1D::init()
         return false;
     }
 
-    // gets the id of the `state` node's attribute, which is the same for all nodes
-    m_stateAttrId = node(0).attrs().indexOf("state");
+    // a typed view of the `state` node's attribute, which is the same for all nodes
+    m_state = nodeAttr<bool>("state");
 
     // determines which rule to use
     m_rule = attr("rule").toInt();
+    if (m_rule < 0 || m_rule > 255) {
+        qWarning() << "the rule must be in the range [0,255]";
+        return false;
+    }
+    // compiles the rule: the bit i is the next state for the pattern i,
+    // where i = (left << 2) | (center << 1) | right
+    for (int i = 0; i < 8; ++i) {
+        m_ruleMasks[i] = (m_rule >> i) & 1 ? ~quint64(0) : 0;
+    }
+
+    // the neighbours are taken from the row and column; no edges needed
+    graph()->setEdgesRequired(false);
+
+    if (!m_state.isValid() || graph()->numNodes() != m_width * m_height) {
+        return false;
+    }
 
-    return m_stateAttrId >= 0;
+    // squareGrid uses the node id as the linear index of the cell, so the
+    // nodes are looked up once here instead of in every step
+    m_cells.assign(static_cast<size_t>(graph()->numNodes()), Node());
+    for (const Node& node : nodes()) {
+        if (node.id() < 0 || node.id() >= graph()->numNodes()) {
+            return false;
+        }
+        m_cells[static_cast<size_t>(node.id())] = node;
+    }
+
+    const int numWords = (m_width + 63) / 64;
+    m_row.assign(numWords, 0);
+    m_nextRow.assign(numWords, 0);
+    packRow();
+    return true;
+}
+
+void CellularAutomata1D::beforeLoop()
+{
+    // the cells might have been edited while paused (e.g., in the GUI)
+    packRow();
+}
+
+void CellularAutomata1D::packRow()
+{
+    const size_t rowId = static_cast<size_t>(linearIdx(m_currRow, 0));
+    for (int col = 0; col < m_width; ++col) {
+        setCell(m_row, col, m_state(m_cells[rowId + col]));
+    }
 }
 
 bool CellularAutomata1D::algorithmStep()
 {
-    // 1. gets first node in the current row
-    Node first = node(linearIdx(m_currRow, 0));
-
-    // 2. for each node (starting from the second),
-    int lastColumn = m_width - 1;
-    for (int col = 1; col < lastColumn; ++col) {
-        Node central = node(first.id() + col);
-        // a. compute the next state based on its neighbours on the left and right
-        Value state = nextState(node(central.id()-1), central, node(central.id()+1));
-        // b. assign the next state to the node below the current node
-        node(central.id()+m_width).setAttr(m_stateAttrId, state);
+    const int numWords = static_cast<int>(m_row.size());
+    const int lastColumn = m_width - 1;
+
+    // 1. compute the next state of 64 cells at a time based on their
+    //    neighbours on the left (col-1) and right (col+1)
+    for (int k = 0; k < numWords; ++k) {
+        const quint64 center = m_row[k];
+        const quint64 left = (center << 1) | (k > 0 ? m_row[k-1] >> 63 : 0);
+        const quint64 right = (center >> 1) | (k + 1 < numWords ? m_row[k+1] << 63 : 0);
+        m_nextRow[k] = nextState(left, center, right);
     }
 
-    // 3. edge case: if the graph is a toroid, we compute the state for the last column
+    // 2. edge case: the first and last columns
+    const bool first = cell(m_row, 0);
+    const bool last = cell(m_row, lastColumn);
     if (m_toroidal) {
-        Node last = node(linearIdx(m_currRow, lastColumn));
-        // a. compute the next state based on its left neighbour and the first node in the row
-        Value state = nextState(node(last.id()-1), last, first);
-        // b. assign the next state to the first node of the next row
-        node(first.id()+m_width).setAttr(m_stateAttrId, state);
+        // the neighbour on the left of the first column is the last column and vice-versa
+        const bool second = m_width > 1 ? cell(m_row, 1) : first;
+        const bool beforeLast = m_width > 1 ? cell(m_row, lastColumn - 1) : last;
+        setCell(m_nextRow, 0, (m_rule >> ((last << 2) | (first << 1) | second)) & 1);
+        setCell(m_nextRow, lastColumn, (m_rule >> ((beforeLast << 2) | (last << 1) | first)) & 1);
+    } else {
+        // fixed boundaries: the first and last columns keep their states
+        setCell(m_nextRow, 0, m_state(m_cells[linearIdx(m_currRow + 1, 0)]));
+        setCell(m_nextRow, lastColumn, m_state(m_cells[linearIdx(m_currRow + 1, lastColumn)]));
+    }
+
+    // 3. assign the next states to the row below
+    const int firstCol = m_toroidal ? 0 : 1;
+    const int lastCol = m_toroidal ? lastColumn : lastColumn - 1;
+    const int nextRowId = linearIdx(m_currRow + 1, 0);
+    for (int col = firstCol; col <= lastCol; ++col) {
+        m_state.set(m_cells[nextRowId + col], cell(m_nextRow, col));
     }
+    m_row.swap(m_nextRow);
 
     ++m_currRow;
     if (m_currRow == m_height-1) {
@@ -74,27 +132,6 @@ bool CellularAutomata1D::algorithmStep()
     return true;
 }
 
-Value CellularAutomata1D::nextState(const Node& leftNode, const Node& node, const Node& rightNode) const
-{
-    bool left = leftNode.attr(m_stateAttrId).toBool();
-    bool center = node.attr(m_stateAttrId).toBool();
-    bool right = rightNode.attr(m_stateAttrId).toBool();
-
-    bool r = false;
-    if (m_rule == 30) {
-        r = left ^ (center || right);
-    } else if (m_rule == 32) {
-        r = left && !center && right;
-    } else if (m_rule == 110) {
-        r = (!left && center) || (center ^ right);
-    } else if (m_rule == 250) {
-        r = left || right;
-    } else {
-        qFatal("invalid rule");
-    }
-    return Value(r);
-}
-
 int CellularAutomata1D::linearIdx(int row, int col) const
 {
     return row * m_width + col;
@@ -9,6 +9,7 @@
 #ifndef CELLULARAUTOMATA1D_H
 #define CELLULARAUTOMATA1D_H
 
+#include <vector>
 #include <plugininterface.h>
 
 namespace evoplex {
@@ -16,24 +17,60 @@ class CellularAutomata1D: public AbstractModel
 {
 public:
     bool init() override;
+    void beforeLoop() override;
     bool algorithmStep() override;
 
 private:
     int m_currRow;
 
-    int m_stateAttrId;  // the id of the `state` node attribute
+    NodeAttr<bool> m_state;    // the `state` node attribute
+    std::vector<Node> m_cells; // the nodes by their linear index (node id)
     int m_rule;         // model attribute: cellular automaton rule
 
     bool m_toroidal;    // true if the graph is a toroid
     int m_width;        // the number of columns in the `squareGrid` graph
     int m_height;       // the number of rows in the `squareGrid` graph
 
-    // returns the next state of a node based on the state
-    // of itself and its neighbours on the left and right
-    Value nextState(const Node& leftNode, const Node& node, const Node& rightNode) const;
+    // The current row is packed in 64-bit words (the bit j of the word k
+    // is the column 64*k+j) and the rule is evaluated for 64 cells at a time.
+    std::vector<quint64> m_row;
+    std::vector<quint64> m_nextRow;
+    quint64 m_ruleMasks[8]; // all ones if the bit i of the rule is set; zero otherwise
+
+    // returns the next state of 64 cells (center) based on the state of
+    // their neighbours on the left and right
+    inline quint64 nextState(quint64 left, quint64 center, quint64 right) const;
+
+    inline bool cell(const std::vector<quint64>& row, int col) const;
+    inline void setCell(std::vector<quint64>& row, int col, bool b) const;
+
+    // loads m_row from the `state` of the nodes in the current row
+    void packRow();
 
     // return the linear index of an element in a matrix.
     int linearIdx(int row, int col) const;
 };
+
+inline quint64 CellularAutomata1D::nextState(quint64 left, quint64 center, quint64 right) const
+{
+    // the rule table as a tree of multiplexers: right, then center, then left
+    const quint64* m = m_ruleMasks;
+    const quint64 x00 = (right & m[1]) | (~right & m[0]);
+    const quint64 x01 = (right & m[3]) | (~right & m[2]);
+    const quint64 x10 = (right & m[5]) | (~right & m[4]);
+    const quint64 x11 = (right & m[7]) | (~right & m[6]);
+    const quint64 y0 = (center & x01) | (~center & x00);
+    const quint64 y1 = (center & x11) | (~center & x10);
+    return (left & y1) | (~left & y0);
+}
+
+inline bool CellularAutomata1D::cell(const std::vector<quint64>& row, int col) const
+{ return (row[col / 64] >> (col % 64)) & 1; }
+
+inline void CellularAutomata1D::setCell(std::vector<quint64>& row, int col, bool b) const
+{
+    const quint64 mask = quint64(1) << (col % 64);
+    if (b) row[col / 64] |= mask; else row[col / 64] &= ~mask;
+}
 } // evoplex
 #endif // CELLULARAUTOMATA1D_H
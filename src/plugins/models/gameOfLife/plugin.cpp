@@ -6,54 +6,221 @@
  * the LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <QtAlgorithms>
+
 #include "plugin.h"
 
 namespace evoplex {
 
+namespace {
+// adds a one-bit input to the three-bit counters (s2,s1,s0) of 64 cells
+// it counts modulo 8, which is fine as we only care about 2 and 3
+inline void add(quint64& s0, quint64& s1, quint64& s2, const quint64 x)
+{
+    const quint64 c0 = s0 & x;
+    s0 ^= x;
+    const quint64 c1 = s1 & c0;
+    s1 ^= c0;
+    s2 ^= c1;
+}
+}
+
 bool GameOfLife::init()
 {
-    // gets the id of the `live` node's attribute, which is the same for all nodes
-    m_liveAttrId = node(0).attrs().indexOf("live");
-    return m_liveAttrId >= 0;
+    // a typed view of the `live` node's attribute, which is the same for all nodes
+    m_live = nodeAttr<bool>("live");
+    if (!m_live.isValid()) {
+        return false;
+    }
+
+    m_packed = initPacked();
+    if (m_packed) {
+        // the packed kernel does not use the edges
+        graph()->setEdgesRequired(false);
+    } else {
+        // only the cells which flipped and their neighbours can change
+        enableActiveSet();
+    }
+    return true;
+}
+
+void GameOfLife::beforeLoop()
+{
+    // the cells might have been edited while paused (e.g., in the GUI)
+    if (m_packed) {
+        packCells();
+    }
 }
 
 bool GameOfLife::algorithmStep()
 {
-    std::vector<Value> nextStates;
-    nextStates.reserve(nodes().size());
+    if (m_packed) {
+        packedStep();
+    } else {
+        genericStep();
+    }
+    return true;
+}
 
-    for (Node node : nodes()) {
+void GameOfLife::genericStep()
+{
+    // We only visit the active nodes, i.e., all nodes in the first step;
+    // then, the nodes which flipped in the last step and their neighbours.
+    for (const Node& node : activeNodes()) {
         int liveNeighbourCount = 0;
         for (Node neighbour : node.outEdges()){
-            if (neighbour.attr(m_liveAttrId).toBool()) {
+            if (m_live(neighbour)) {
                 ++liveNeighbourCount;
             }
         }
 
-        if (node.attr(m_liveAttrId).toBool()) {
-            if (liveNeighbourCount < 2) { // Dies due to underpopulation
-                nextStates.emplace_back(false);
-            } else if (liveNeighbourCount < 4) { // Lives to next state
-                nextStates.emplace_back(true);
-            }  else { // Dies due to overpopulation
-                nextStates.emplace_back(false);
-            }
+        const bool live = m_live(node);
+        bool nextState;
+        if (live) {
+            // Dies due to underpopulation (<2) or overpopulation (>3)
+            nextState = liveNeighbourCount == 2 || liveNeighbourCount == 3;
         } else {
             // Any dead node with exactly three live neighbors
             // becomes a live node, as if by reproduction.
-            nextStates.emplace_back(liveNeighbourCount == 3);
+            nextState = liveNeighbourCount == 3;
+        }
+
+        if (nextState != live) {
+            m_flipped.emplace_back(node);
         }
     }
 
-    // For each node, load the next state into the current state
-    size_t i = 0;
-    for (Node node : nodes()) {
-        node.setAttr(m_liveAttrId, nextStates.at(i));
-        ++i;
+    // For each flipped node, load the next state into the current state
+    for (Node node : m_flipped) {
+        m_live.set(node, !m_live(node));
+        markDirty(node);
     }
+    m_flipped.clear();
+}
+
+bool GameOfLife::initPacked()
+{
+    if (graphId() != "squareGrid" || graph()->attr("neighbours").toInt() != 8) {
+        return false;
+    }
+
+    m_width = graph()->attr("width").toInt();
+    m_height = graph()->attr("height").toInt();
+    m_periodic = graph()->attr("boundary").toQString() == "periodic";
+    // in tiny grids, a node might be its own neighbour (or a neighbour twice);
+    // let's keep it simple and use the edges in that case
+    if (m_width < 3 || m_height < 3 || graph()->numNodes() != m_width * m_height) {
+        return false;
+    }
+
+    m_wordsPerRow = (m_width + 63) / 64;
+    const int tailBits = m_width % 64;
+    m_lastWordMask = tailBits ? (quint64(1) << tailBits) - 1 : ~quint64(0);
+
+    const size_t numWords = static_cast<size_t>(m_wordsPerRow) * m_height;
+    m_cells.assign(numWords, 0);
+    m_next.assign(numWords, 0);
+    m_west.assign(numWords, 0);
+    m_east.assign(numWords, 0);
+    m_zeros.assign(static_cast<size_t>(m_wordsPerRow), 0);
+
+    // squareGrid uses the node id as the linear index of the cell
+    for (const Node& node : nodes()) {
+        if (node.id() < 0 || node.id() >= graph()->numNodes()) {
+            return false;
+        }
+    }
+    packCells();
     return true;
 }
 
+void GameOfLife::packCells()
+{
+    std::fill(m_cells.begin(), m_cells.end(), 0);
+    for (const Node& node : nodes()) {
+        if (m_live(node)) {
+            const int row = node.id() / m_width;
+            const int col = node.id() % m_width;
+            m_cells[row * m_wordsPerRow + col / 64] |= quint64(1) << (col % 64);
+        }
+    }
+}
+
+void GameOfLife::packedStep()
+{
+    const int nw = m_wordsPerRow;
+    const int lastCol = m_width - 1;
+
+    // shift each row to align the cells with their west and east neighbours
+    for (int r = 0; r < m_height; ++r) {
+        const quint64* c = &m_cells[r * nw];
+        quint64* w = &m_west[r * nw];
+        quint64* e = &m_east[r * nw];
+        for (int k = 0; k < nw; ++k) {
+            w[k] = (c[k] << 1) | (k > 0 ? c[k-1] >> 63 : 0);
+            e[k] = (c[k] >> 1) | (k + 1 < nw ? c[k+1] << 63 : 0);
+        }
+        if (m_periodic) {
+            w[0] |= (c[lastCol / 64] >> (lastCol % 64)) & 1;
+            e[lastCol / 64] |= (c[0] & 1) << (lastCol % 64);
+        }
+        w[nw-1] &= m_lastWordMask;
+    }
+
+    auto row = [this, nw](const std::vector<quint64>& grid, int r) {
+        if (r < 0 || r >= m_height) {
+            if (!m_periodic) return m_zeros.data();
+            r = r < 0 ? m_height - 1 : 0;
+        }
+        return grid.data() + r * nw;
+    };
+
+    for (int r = 0; r < m_height; ++r) {
+        const quint64* wu = row(m_west, r-1);
+        const quint64* cu = row(m_cells, r-1);
+        const quint64* eu = row(m_east, r-1);
+        const quint64* wc = row(m_west, r);
+        const quint64* cc = row(m_cells, r);
+        const quint64* ec = row(m_east, r);
+        const quint64* wd = row(m_west, r+1);
+        const quint64* cd = row(m_cells, r+1);
+        const quint64* ed = row(m_east, r+1);
+        quint64* next = &m_next[r * nw];
+
+        for (int k = 0; k < nw; ++k) {
+            quint64 s0 = 0, s1 = 0, s2 = 0;
+            add(s0, s1, s2, wu[k]);
+            add(s0, s1, s2, cu[k]);
+            add(s0, s1, s2, eu[k]);
+            add(s0, s1, s2, wc[k]);
+            add(s0, s1, s2, ec[k]);
+            add(s0, s1, s2, wd[k]);
+            add(s0, s1, s2, cd[k]);
+            add(s0, s1, s2, ed[k]);
+            // alive if it has 3 live neighbours, or 2 if it's alive already
+            next[k] = s1 & ~s2 & (s0 | cc[k]);
+        }
+    }
+
+    // materialise only the cells which flipped
+    for (size_t i = 0; i < m_next.size(); ++i) {
+        quint64 diff = m_next[i] ^ m_cells[i];
+        if (!diff) {
+            continue;
+        }
+        const int r = static_cast<int>(i) / nw;
+        const int colOffset = (static_cast<int>(i) % nw) * 64;
+        do {
+            const int j = static_cast<int>(qCountTrailingZeroBits(diff));
+            m_live.set(node(r * m_width + colOffset + j), ((m_next[i] >> j) & 1) != 0);
+            diff &= diff - 1;
+        } while (diff);
+    }
+
+    m_cells.swap(m_next);
+}
+
 } // evoplex
 REGISTER_PLUGIN(GameOfLife)
 #include "plugin.moc"
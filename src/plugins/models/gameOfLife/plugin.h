@@ -9,6 +9,7 @@
 #ifndef GAME_OF_LIFE_H
 #define GAME_OF_LIFE_H
 
+#include <vector>
 #include <plugininterface.h>
 
 namespace evoplex {
@@ -16,10 +17,33 @@ class GameOfLife: public AbstractModel
 {
 public:
     bool init() override;
+    void beforeLoop() override;
     bool algorithmStep() override;
 
 private:
-    int m_liveAttrId;  // the id of the 'live' node's attribute
+    NodeAttr<bool> m_live; // the 'live' node's attribute
+    std::vector<Node> m_flipped; // nodes which flip their state in the current step
+
+    // Fast path for a squareGrid with eight neighbours.
+    // The cells are packed in 64-bit words, row by row (the bit j of the
+    // word k of a row is the column 64*k+j), and the rule is evaluated
+    // for 64 cells at a time with bitwise adders.
+    bool m_packed;
+    bool m_periodic;
+    int m_width;
+    int m_height;
+    int m_wordsPerRow;
+    quint64 m_lastWordMask; // valid bits of the last word of each row
+    std::vector<quint64> m_cells;
+    std::vector<quint64> m_next;
+    std::vector<quint64> m_west; // state of the neighbour on the west (col-1)
+    std::vector<quint64> m_east; // state of the neighbour on the east (col+1)
+    std::vector<quint64> m_zeros; // an empty row (fixed boundary)
+
+    bool initPacked();
+    void packCells(); // loads m_cells from the 'live' attribute
+    void packedStep();
+    void genericStep();
 };
 } // evoplex
 #endif // GAME_OF_LIFEL_H
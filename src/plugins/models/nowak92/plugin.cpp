@@ -5,6 +5,10 @@
  * the LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
 #include "plugin.h"
 
 namespace evoplex {
@@ -12,51 +16,107 @@ namespace evoplex {
 bool ModelNowak::init()
 {
     m_temptation = attr("temptation", -1.0).toDouble();
-    return m_temptation >=1.0 && m_temptation <= 2.0;
+    m_strategyAttr = nodeAttr<qint8>("strategy");
+    m_scoreAttr = nodeAttr<double>("score");
+    return m_temptation >=1.0 && m_temptation <= 2.0
+            && m_strategyAttr.isValid() && m_scoreAttr.isValid();
+}
+
+void ModelNowak::beforeLoop()
+{
+    // the nodes might have been edited while paused (e.g., in the GUI)
+    for (size_t i = 0; i < m_nodesIdx.size(); ++i) {
+        m_strategy[i] = m_strategyAttr(m_nodesIdx[i]);
+        m_score[i] = m_scoreAttr(m_nodesIdx[i]);
+    }
 }
 
 bool ModelNowak::algorithmStep()
 {
+    if (m_nodesIdx.empty()) {
+        buildColumns();
+    }
+
+    const int numNodes = static_cast<int>(m_nodesIdx.size());
+
     // 1. each agent accumulates the payoff obtained by playing
-    //    the game with all its neighbours and itself
-    for (Node node : nodes()) {
-        const int sX = node.attr(STRATEGY).toInt();
-        double score = playGame(sX, sX);
-        for (const Node& neighbour : node.outEdges()) {
-            score += playGame(sX, neighbour.attr(STRATEGY).toInt());
+    //    the game with all its neighbours and itself, i.e.,
+    //    it only depends on the number of cooperating neighbours
+    for (int i = 0; i < numNodes; ++i) {
+        int numCooperators = 0;
+        for (int n = m_nbrsBegin[i]; n < m_nbrsBegin[i+1]; ++n) {
+            numCooperators += 1 - (m_strategy[m_nbrs[n]] & 1);
+        }
+        const double score = (m_strategy[i] & 1)
+                ? m_defectorPayoff[numCooperators]
+                : 1.0 + numCooperators; // CC with itself and each cooperator
+        if (score != m_score[i]) {
+            m_score[i] = score;
+            m_scoreAttr.set(m_nodesIdx[i], score);
         }
-        node.setAttr(SCORE, score);
     }
 
-    std::vector<char> bestStrategies;
-    bestStrategies.reserve(nodes().size());
-
     // 2. the best agent in the neighbourhood is selected to reproduce
-    for (const Node& node : nodes()) {
-        int bestStrategy = node.attr(STRATEGY).toInt();
-        double highestScore = node.attr(SCORE).toDouble();
-        for (const Node& neighbour : node.outEdges()) {
-            const double neighbourScore = neighbour.attr(SCORE).toDouble();
-            if (neighbourScore > highestScore) {
-                highestScore = neighbourScore;
-                bestStrategy = neighbour.attr(STRATEGY).toInt();
+    for (int i = 0; i < numNodes; ++i) {
+        qint8 bestStrategy = m_strategy[i];
+        double highestScore = m_score[i];
+        for (int n = m_nbrsBegin[i]; n < m_nbrsBegin[i+1]; ++n) {
+            const int j = m_nbrs[n];
+            if (m_score[j] > highestScore) {
+                highestScore = m_score[j];
+                bestStrategy = m_strategy[j];
             }
         }
-        bestStrategies.emplace_back(binarize(bestStrategy));
+        // 3. prepare the next generation
+        const qint8 best = bestStrategy & 1; // binarize
+        const qint8 s = m_strategy[i] & 1;
+        m_nextStrategy[i] = (s == best) ? s : best + 2;
     }
 
-    // 3. prepare the next generation
-    size_t i = 0;
-    for (Node node : nodes()) {
-        int s = binarize(node.attr(STRATEGY).toInt());
-        s = (s == bestStrategies.at(i)) ? s : bestStrategies.at(i) + 2;
-        node.setAttr(STRATEGY, s);
-        ++i;
+    for (int i = 0; i < numNodes; ++i) {
+        if (m_nextStrategy[i] != m_strategy[i]) {
+            m_strategyAttr.set(m_nodesIdx[i], m_nextStrategy[i]);
+        }
     }
+    m_strategy.swap(m_nextStrategy);
 
     return true;
 }
 
+void ModelNowak::buildColumns()
+{
+    const size_t numNodes = nodes().size();
+    m_nodesIdx.reserve(numNodes);
+    std::unordered_map<int, int> idxOf;
+    idxOf.reserve(numNodes);
+    for (const Node& node : nodes()) {
+        idxOf.insert({node.id(), static_cast<int>(m_nodesIdx.size())});
+        m_nodesIdx.emplace_back(node);
+    }
+
+    int maxDegree = 0;
+    m_nbrsBegin.reserve(numNodes + 1);
+    m_nbrsBegin.emplace_back(0);
+    m_strategy.reserve(numNodes);
+    for (const Node& node : m_nodesIdx) {
+        for (const Node& neighbour : node.outEdges()) {
+            m_nbrs.emplace_back(idxOf.at(neighbour.id()));
+        }
+        m_nbrsBegin.emplace_back(static_cast<int>(m_nbrs.size()));
+        maxDegree = std::max(maxDegree, m_nbrsBegin.back() - m_nbrsBegin[m_nbrsBegin.size() - 2]);
+        m_strategy.emplace_back(m_strategyAttr(node));
+    }
+    m_nextStrategy.resize(numNodes);
+    // the current scores are unknown; let's make sure they will be written
+    m_score.assign(numNodes, std::numeric_limits<double>::quiet_NaN());
+
+    // DD with itself, then DC with each cooperator
+    m_defectorPayoff.assign(1, playGame(1, 1));
+    for (int k = 1; k <= maxDegree; ++k) {
+        m_defectorPayoff.emplace_back(m_defectorPayoff.back() + playGame(1, 0));
+    }
+}
+
 // 0) cooperator; 1) new cooperator
 // 2) defector;   3) new defector
 double ModelNowak::playGame(const int sX, const int sY) const
@@ -8,6 +8,7 @@
 #ifndef NOWAK92_H
 #define NOWAK92_H
 
+#include <vector>
 #include <plugininterface.h>
 
 namespace evoplex {
@@ -15,12 +16,28 @@ class ModelNowak: public AbstractModel
 {
 public:
     bool init() override;
+    void beforeLoop() override;
     bool algorithmStep() override;
 
 private:
-    enum NodeAttr { STRATEGY, SCORE };
-
     double m_temptation;
+    NodeAttr<qint8> m_strategyAttr;
+    NodeAttr<double> m_scoreAttr;
+
+    // Columnar state, built in the first step (after the edges exist).
+    // The nodes are indexed in the order of 'nodes()' and the neighbours in
+    // the order of 'outEdges()', so that ties are broken as before.
+    std::vector<Node> m_nodesIdx;
+    std::vector<int> m_nbrsBegin;  // the neighbours of i are in [m_nbrsBegin[i], m_nbrsBegin[i+1])
+    std::vector<int> m_nbrs;
+    std::vector<qint8> m_strategy;
+    std::vector<qint8> m_nextStrategy;
+    std::vector<double> m_score;
+    // payoff of a defector with k cooperating neighbours, summed
+    // in the same order as in 'playGame()' to get the very same values
+    std::vector<double> m_defectorPayoff;
+
+    void buildColumns();
 
     double playGame(const int sX, const int sY) const;
     int binarize(const int strategy) const;
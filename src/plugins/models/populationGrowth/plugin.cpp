@@ -16,23 +16,25 @@ bool PopulationGrowth::init()
     m_infectedAttrId = node(0).attrs().indexOf("infected");
     // initializing model attribute, which is constant throughout the simulation
     m_prob = attr("prob").toDouble();
+    // only the healthy nodes next to infected ones can change
+    enableActiveSet();
 
     return m_infectedAttrId >= 0;
 }
 
 bool PopulationGrowth::algorithmStep()
 {
-    std::vector<Value> nextInfectedStates;
-    nextInfectedStates.reserve(nodes().size());
-
-    for (Node node : nodes()) {
+    // We only visit the active nodes, i.e., all nodes in the first step;
+    // then, the nodes infected in the last step, their neighbours and the
+    // healthy nodes which are still next to an infected one.
+    // Note that the skipped nodes would draw a random neighbour, so the
+    // same seed gives a different trajectory than visiting all nodes.
+    for (const Node& node : activeNodes()) {
         if (node.attr(m_infectedAttrId).toBool()) {
-            nextInfectedStates.emplace_back(true);
             continue; // the node is already infected; skip
         }
 
         if (node.outDegree() < 1) {
-            nextInfectedStates.emplace_back(false);
             continue; // the node does not have neighbours; skip
         }
 
@@ -42,21 +44,35 @@ bool PopulationGrowth::algorithmStep()
         // and check if the neighbour is currently infected
         if (neighbour.attr(m_infectedAttrId).toBool()) {
             // if so, the current node will become infected with a given probability
-            nextInfectedStates.emplace_back(m_prob > prg()->uniform());
-        } else {
-            nextInfectedStates.emplace_back(false);
+            if (m_prob > prg()->uniform()) {
+                m_newInfected.emplace_back(node);
+            } else {
+                keepActive(node); // it may still be infected in the next step
+            }
+        } else if (hasInfectedNeighbour(node)) {
+            keepActive(node);
         }
     }
 
-    // For each node, load the next state into the current state
-    size_t i = 0;
-    for (Node node : nodes()) {
-        node.setAttr(m_infectedAttrId, nextInfectedStates.at(i));
-        ++i;
+    // For each new infected node, load the next state into the current state
+    for (Node node : m_newInfected) {
+        node.setAttr(m_infectedAttrId, true);
+        markDirty(node);
     }
+    m_newInfected.clear();
 
     return true;
 }
+
+bool PopulationGrowth::hasInfectedNeighbour(const Node& node) const
+{
+    for (Node neighbour : node.outEdges()) {
+        if (neighbour.attr(m_infectedAttrId).toBool()) {
+            return true;
+        }
+    }
+    return false;
+}
 } // evoplex
 REGISTER_PLUGIN(PopulationGrowth)
 #include "plugin.moc"
@@ -21,6 +21,9 @@ public:
 private:
     int m_infectedAttrId;   // the id of the 'infected' node's attribute
     double m_prob;          // probability of a node becoming infected
+    std::vector<Node> m_newInfected; // nodes infected in the current step
+
+    bool hasInfectedNeighbour(const Node& node) const;
 };
 } // evoplex
 #endif // POPULATION_GROWTH_H
@@ -0,0 +1,138 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <QtTest>
+#include <core/include/attributerange.h>
+#include <core/include/enum.h>
+#include <core/include/nodes.h>
+#include <core/arena.h>
+#include <core/nodes_p.h>
+
+using namespace evoplex;
+
+class TestArena: public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_allocate();
+    void tst_recycle();
+    void tst_lifetime();
+};
+
+void TestArena::tst_allocate()
+{
+    Arena arena(1024);
+    QCOMPARE(arena.capacity(), size_t(0));
+
+    std::vector<char*> ptrs;
+    for (size_t align : {1, 2, 4, 8, 16, 64}) {
+        for (int i = 0; i < 100; ++i) {
+            char* p = static_cast<char*>(arena.allocate(24, align));
+            QCOMPARE(reinterpret_cast<quintptr>(p) % align, quintptr(0));
+            std::memset(p, i, 24);
+            ptrs.emplace_back(p);
+        }
+    }
+    // no overlaps
+    std::sort(ptrs.begin(), ptrs.end());
+    for (size_t i = 1; i < ptrs.size(); ++i) {
+        QVERIFY(ptrs[i - 1] + 24 <= ptrs[i]);
+    }
+
+    // a large object does not fit in a chunk
+    const size_t capacity = arena.capacity();
+    QVERIFY(arena.allocate(4096, 64) != nullptr);
+    QVERIFY(arena.capacity() >= capacity + 4096);
+}
+
+void TestArena::tst_recycle()
+{
+    Arena arena(1024);
+    void* a = arena.allocate(40, 8);
+    arena.deallocate(a, 40, 8);
+    QCOMPARE(arena.allocate(40, 8), a); // the same size class
+    QVERIFY(arena.allocate(40, 8) != a);
+
+    // objects created and released over and over do not need more memory
+    arena.deallocate(arena.allocate(48), 48);
+    const size_t capacity = arena.capacity();
+    for (int i = 0; i < 10000; ++i) {
+        void* p = arena.allocate(48);
+        std::memset(p, i, 48);
+        arena.deallocate(p, 48);
+    }
+    QCOMPARE(arena.capacity(), capacity);
+
+    // and so do the shared objects
+    ArenaPtr shared = std::make_shared<Arena>(1024);
+    auto obj = makeShared<std::array<char, 40>>(shared);
+    const void* raw = obj.get();
+    obj.reset();
+    obj = makeShared<std::array<char, 40>>(shared);
+    QCOMPARE(static_cast<const void*>(obj.get()), raw);
+
+    // the large objects are only released with the arena
+    void* large = arena.allocate(4096);
+    arena.deallocate(large, 4096);
+    QVERIFY(arena.allocate(4096) != large);
+
+    // and so is everything once the arena is being dropped
+    arena.stopRecycling();
+    void* b = arena.allocate(40, 8);
+    arena.deallocate(b, 40, 8);
+    QVERIFY(arena.allocate(40, 8) != b);
+}
+
+void TestArena::tst_lifetime()
+{
+    AttributesScope attrsScope;
+    auto attrRange = AttributeRange::parse(0, "a", "int[0,1000]");
+    attrsScope.insert(attrRange->attrName(), attrRange);
+    QString errorMsg;
+    const Nodes nodes = NodesPrivate::fromCmd("*100;max", attrsScope,
+                                              GraphType::Undirected, errorMsg);
+    QCOMPARE(nodes.size(), size_t(100));
+
+    std::weak_ptr<Arena> weakArena;
+    Nodes clones;
+    {
+        ArenaPtr arena = std::make_shared<Arena>();
+        weakArena = arena;
+        clones = NodesPrivate::clone(nodes, arena);
+        QVERIFY(arena->capacity() > 0);
+    }
+    // the nodes keep the arena alive
+    QVERIFY(!weakArena.expired());
+    QCOMPARE(clones.size(), nodes.size());
+    for (auto const& p : clones) {
+        QCOMPARE(p.second.attr(0), Value(1000));
+        QCOMPARE(p.second.id(), p.first);
+    }
+    clones = Nodes();
+    QVERIFY(weakArena.expired());
+}
+
+QTEST_MAIN(TestArena)
+#include "tst_arena.moc"
@@ -19,6 +19,7 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cfloat>
 #include <memory>
 #include <QtTest>
 #include <attributerange.h>
@@ -42,6 +43,8 @@ private slots:
     void tst_double_set();
     void tst_filepath();
     void tst_dirpath();
+    void tst_narrow_int();
+    void tst_float();
     void tst_string() { _tst_string(true); }
     void tst_nonEmptyString() { _tst_string(false); }
 
@@ -620,5 +623,84 @@ void TestAttributeRange::tst_dirpath()
     QCOMPARE(attrRge->next("abc"), Value("abc"));
 }
 
+void TestAttributeRange::tst_narrow_int()
+{
+    // ranges
+    auto attrRge = AttributeRange::parse(0, "test", "int8[-5,max]");
+    QVERIFY(attrRge->isValid());
+    QCOMPARE(attrRge->attrRangeStr(), QString("int8[-5,127]"));
+    QCOMPARE(attrRge->type(), AttributeRange::Int_Range);
+    QCOMPARE(attrRge->validate("127"), Value(127));
+    QCOMPARE(attrRge->validate("128"), Value());
+    Value v = attrRge->rand(m_prg.get());
+    QCOMPARE(v.type(), Value::INT);
+    QVERIFY(v.toInt() >= -5 && v.toInt() <= 127);
+
+    attrRge = AttributeRange::parse(0, "test", "uint16[0,max]");
+    QVERIFY(attrRge->isValid());
+    QCOMPARE(attrRge->attrRangeStr(), QString("uint16[0,65535]"));
+    QCOMPARE(attrRge->validate("65535"), Value(65535));
+    QCOMPARE(attrRge->validate("-1"), Value());
+
+    QCOMPARE(AttributeRange::parse(0, "test", "int16[-32768,max]")->attrRangeStr(),
+             QString("int16[-32768,32767]"));
+    QCOMPARE(AttributeRange::parse(0, "test", "int[0,1]")->attrRangeStr(), QString("int[0,1]"));
+
+    // out of the limits of the type
+    QVERIFY(!AttributeRange::parse(0, "test", "int8[0,128]")->isValid());
+    QVERIFY(!AttributeRange::parse(0, "test", "uint8[-1,1]")->isValid());
+    QVERIFY(!AttributeRange::parse(0, "test", "uint16[0,65536]")->isValid());
+    QVERIFY(!AttributeRange::parse(0, "test", "int9[0,1]")->isValid());
+
+    // sets
+    attrRge = AttributeRange::parse(0, "test", "int8{0,1,2,3}");
+    QVERIFY(attrRge->isValid());
+    QCOMPARE(attrRge->attrRangeStr(), QString("int8{0,1,2,3}"));
+    QCOMPARE(attrRge->type(), AttributeRange::Int_Set);
+    QCOMPARE(attrRge->validate("3"), Value(3));
+    QCOMPARE(attrRge->validate("4"), Value());
+    QCOMPARE(attrRge->next(3), Value(0));
+
+    attrRge = AttributeRange::parse(0, "test", "uint8{0,255}");
+    QVERIFY(attrRge->isValid());
+    QCOMPARE(attrRge->attrRangeStr(), QString("uint8{0,255}"));
+    QVERIFY(!AttributeRange::parse(0, "test", "uint8{0,256}")->isValid());
+}
+
+void TestAttributeRange::tst_float()
+{
+    // the values are rounded to floats
+    const double f01 = static_cast<double>(0.1f);
+    auto attrRge = AttributeRange::parse(0, "test", "float[0.1,16]");
+    QVERIFY(attrRge->isValid());
+    QCOMPARE(attrRge->attrRangeStr(), QString("float[0.1,16]"));
+    QCOMPARE(attrRge->type(), AttributeRange::Double_Range);
+    QCOMPARE(attrRge->min(), Value(f01));
+    QCOMPARE(attrRge->validate("0.1"), Value(f01));
+    QCOMPARE(attrRge->validate("0.05"), Value());
+    for (int i = 0; i < 100; ++i) {
+        const double v = attrRge->rand(m_prg.get()).toDouble();
+        QCOMPARE(v, static_cast<double>(static_cast<float>(v)));
+        QVERIFY(v >= f01 && v <= 16.0);
+    }
+
+    attrRge = AttributeRange::parse(0, "test", "float[0,max]");
+    QVERIFY(attrRge->isValid());
+    QCOMPARE(attrRge->max().toDouble(), static_cast<double>(FLT_MAX));
+    QVERIFY(!AttributeRange::parse(0, "test", "float[0,1e39]")->isValid());
+
+    attrRge = AttributeRange::parse(0, "test", "float{0.1,0.5}");
+    QVERIFY(attrRge->isValid());
+    QCOMPARE(attrRge->attrRangeStr(), QString("float{0.1,0.5}"));
+    QCOMPARE(attrRge->type(), AttributeRange::Double_Set);
+    QCOMPARE(attrRge->validate("0.1"), Value(f01));
+    QCOMPARE(attrRge->validate("0.2"), Value());
+
+    // doubles are not rounded
+    attrRge = AttributeRange::parse(0, "test", "double[0.1,1]");
+    QCOMPARE(attrRge->attrRangeStr(), QString("double[0.1,1]"));
+    QCOMPARE(attrRge->min(), Value(0.1));
+}
+
 QTEST_MAIN(TestAttributeRange)
 #include "tst_attributerange.moc"
@@ -0,0 +1,182 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <limits>
+#include <QtTest>
+#include <core/include/attributerange.h>
+#include <core/include/enum.h>
+#include <core/include/nodes.h>
+#include <core/edge_p.h>
+#include <core/forcelayout.h>
+#include <core/node_p.h>
+#include <core/nodes_p.h>
+
+namespace evoplex {
+class TestForceLayout: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase() {}
+    void tst_lacksCoords();
+    void tst_empty();
+    void tst_layout();
+    void tst_deterministic();
+
+private:
+    Nodes m_nodes;
+    int m_lastEdgeId = -1;
+
+    Nodes createNodes(int numNodes) const;
+    void addEdge(const Node& origin, const Node& neighbour);
+    static float distance(const Node& a, const Node& b);
+};
+
+void TestForceLayout::initTestCase()
+{
+    // a ring with 100 nodes
+    m_nodes = createNodes(100);
+    for (int id = 0; id < 100; ++id) {
+        addEdge(m_nodes.at(id), m_nodes.at((id + 1) % 100));
+    }
+}
+
+Nodes TestForceLayout::createNodes(int numNodes) const
+{
+    AttributesScope attrsScope;
+    auto attrRange = AttributeRange::parse(0, "a", "int[0,1]");
+    attrsScope.insert(attrRange->attrName(), attrRange);
+    QString errorMsg;
+    Nodes nodes = NodesPrivate::fromCmd(QString("*%1;min").arg(numNodes),
+            attrsScope, GraphType::Undirected, errorMsg);
+    Q_ASSERT(nodes.size() == static_cast<size_t>(numNodes));
+    return nodes;
+}
+
+void TestForceLayout::addEdge(const Node& origin, const Node& neighbour)
+{
+    // same as AbstractGraph::addEdge()
+    ++m_lastEdgeId;
+    BaseEdge::constructor_key k;
+    origin.m_ptr->addOutEdge(Edge(std::make_shared<BaseEdge>(k, m_lastEdgeId, origin, neighbour)));
+    neighbour.m_ptr->addInEdge(Edge(std::make_shared<BaseEdge>(k, m_lastEdgeId, neighbour, origin)));
+}
+
+float TestForceLayout::distance(const Node& a, const Node& b)
+{
+    return std::hypot(a.x() - b.x(), a.y() - b.y());
+}
+
+void TestForceLayout::tst_lacksCoords()
+{
+    Nodes nodes = createNodes(10);
+    QVERIFY(ForceLayout::lacksCoords(nodes));
+    Node(nodes.at(3)).setX(1.f);
+    QVERIFY(!ForceLayout::lacksCoords(nodes));
+    QVERIFY(!ForceLayout::lacksCoords(createNodes(1)));
+
+    // e.g., a squareGrid with a single column places the nodes at the
+    // default coordinates (0, id), but they are not lacking coordinates
+    nodes = createNodes(10);
+    for (Node node : nodes) {
+        QCOMPARE(node.x(), 0.f);
+        QCOMPARE(node.y(), static_cast<float>(node.id()));
+        node.setCoords(0.f, node.id());
+    }
+    QVERIFY(!ForceLayout::lacksCoords(nodes));
+
+    // the clones keep it
+    QVERIFY(ForceLayout::lacksCoords(NodesPrivate::clone(createNodes(10))));
+    QVERIFY(!ForceLayout::lacksCoords(NodesPrivate::clone(nodes)));
+}
+
+void TestForceLayout::tst_empty()
+{
+    ForceLayout layout((Nodes()));
+    QCOMPARE(layout.size(), size_t(0));
+    QVERIFY(layout.isDone());
+    QVERIFY(layout.iterate(10));
+    QCOMPARE(layout.iterations(), 0);
+    layout.apply();
+}
+
+void TestForceLayout::tst_layout()
+{
+    ForceLayout layout(m_nodes, 123);
+    QCOMPARE(layout.size(), m_nodes.size());
+    QVERIFY(!layout.isDone());
+
+    const float t0 = layout.temperature();
+    QVERIFY(!layout.iterate(1));
+    QCOMPARE(layout.iterations(), 1);
+    QVERIFY(layout.temperature() < t0);
+
+    int numIterations = 1;
+    while (!layout.iterate(10)) {
+        numIterations += 10;
+        QVERIFY(numIterations < 1000);
+    }
+    QVERIFY(layout.isDone());
+
+    layout.apply();
+    QVERIFY(!ForceLayout::lacksCoords(m_nodes));
+    for (size_t i = 0; i < layout.size(); ++i) {
+        const Node& node = layout.node(i);
+        QCOMPARE(node.x(), layout.x(i));
+        QCOMPARE(node.y(), layout.y(i));
+        QVERIFY(std::isfinite(node.x()) && std::isfinite(node.y()));
+    }
+
+    // the neighbours must be much closer than the opposite nodes in the ring,
+    // and no node should be on top of another
+    float neighbours = 0.f;
+    float opposites = 0.f;
+    float minDistance = std::numeric_limits<float>::max();
+    for (int id = 0; id < 100; ++id) {
+        const Node& node = m_nodes.at(id);
+        neighbours += distance(node, m_nodes.at((id + 1) % 100));
+        opposites += distance(node, m_nodes.at((id + 50) % 100));
+        for (int other = id + 1; other < 100; ++other) {
+            minDistance = std::min(minDistance, distance(node, m_nodes.at(other)));
+        }
+    }
+    QVERIFY(neighbours * 3.f < opposites);
+    QVERIFY(minDistance > 0.1f);
+}
+
+void TestForceLayout::tst_deterministic()
+{
+    ForceLayout l1(m_nodes, 7);
+    ForceLayout l2(m_nodes, 7);
+    l1.iterate(20);
+    l2.iterate(20);
+    for (size_t i = 0; i < l1.size(); ++i) {
+        QVERIFY(l1.node(i) == l2.node(i));
+        QCOMPARE(l1.x(i), l2.x(i));
+        QCOMPARE(l1.y(i), l2.y(i));
+    }
+}
+
+} // evoplex
+
+QTEST_MAIN(evoplex::TestForceLayout)
+#include "tst_forcelayout.moc"
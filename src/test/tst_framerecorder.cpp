@@ -0,0 +1,154 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <core/include/attributerange.h>
+#include <core/include/enum.h>
+#include <core/include/nodes.h>
+#include <core/framerecorder.h>
+#include <core/nodes_p.h>
+
+namespace evoplex {
+class TestFrameRecorder: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_rgb();
+    void tst_grid();
+    void tst_graph();
+
+private:
+    const Colors m_colors {
+        QColor(255, 0, 0), QColor(0, 255, 0), QColor(0, 0, 255)
+    };
+
+    static Nodes createNodes(int numNodes, AttributeRangePtr attrRange);
+};
+
+Nodes TestFrameRecorder::createNodes(int numNodes, AttributeRangePtr attrRange)
+{
+    AttributesScope attrsScope;
+    attrsScope.insert(attrRange->attrName(), attrRange);
+    QString errorMsg;
+    Nodes nodes = NodesPrivate::fromCmd(QString("*%1;min").arg(numNodes),
+            attrsScope, GraphType::Undirected, errorMsg);
+    Q_ASSERT(nodes.size() == static_cast<size_t>(numNodes));
+    return nodes;
+}
+
+void TestFrameRecorder::tst_rgb()
+{
+    // the values are mapped as in the GUI (see ColorMap)
+    FrameRecorder interval(nullptr, AttributeRange::parse(0, "a", "double[0,1]"), 1, "");
+    interval.setColors(m_colors);
+    QCOMPARE(interval.rgb(Value(0.)), m_colors[0].rgb());
+    QCOMPARE(interval.rgb(Value(0.4)), m_colors[1].rgb());
+    QCOMPARE(interval.rgb(Value(0.9)), m_colors[2].rgb());
+    QCOMPARE(interval.rgb(Value(1.)), m_colors[2].rgb());
+    QCOMPARE(interval.rgb(Value(5.)), QRgb(0)); // out of range
+    QCOMPARE(interval.rgb(Value()), QRgb(0));
+
+    FrameRecorder boolean(nullptr, AttributeRange::parse(0, "a", "bool"), 1, "");
+    boolean.setColors(m_colors);
+    QCOMPARE(boolean.rgb(Value(false)), m_colors[0].rgb());
+    QCOMPARE(boolean.rgb(Value(true)), m_colors[1].rgb());
+
+    // each value of a set takes the next colour
+    FrameRecorder set(nullptr, AttributeRange::parse(0, "a", "int{2,5,9,11}"), 1, "");
+    set.setColors(m_colors);
+    QCOMPARE(set.rgb(Value(2)), m_colors[0].rgb());
+    QCOMPARE(set.rgb(Value(5)), m_colors[1].rgb());
+    QCOMPARE(set.rgb(Value(9)), m_colors[2].rgb());
+    QCOMPARE(set.rgb(Value(11)), m_colors[0].rgb());
+}
+
+void TestFrameRecorder::tst_grid()
+{
+    // a grid with 3 columns and 2 rows; node 'id' is at (id % 3, id / 3)
+    auto attrRange = AttributeRange::parse(0, "a", "int[0,2]");
+    Nodes nodes = createNodes(6, attrRange);
+    for (auto& np : nodes) {
+        Node(np.second).setCoords(np.first % 3, np.first / 3);
+    }
+
+    FrameRecorder recorder(nullptr, attrRange, 1, "");
+    recorder.setColors(m_colors);
+    recorder.setCellLength(2);
+    recorder.setGeometry(nodes, Edges());
+
+    // the last node has no value
+    const Values values { Value(0), Value(1), Value(2), Value(2), Value(1), Value() };
+    const QImage img = recorder.render(values);
+    QCOMPARE(img.size(), QSize(6, 4));
+
+    for (int id = 0; id < 6; ++id) {
+        const QRgb expected = id < 5 ? m_colors[values[id].rgb().toInt()] : QRgb(0);
+        const int col = (id % 3) * 2;
+        const int row = (id / 3) * 2;
+        // every pixel of the cell
+        QCOMPARE(img.pixel(col, row), expected);
+        QCOMPARE(img.pixel(col + 1, row), expected);
+        QCOMPARE(img.pixel(col, row + 1), expected);
+        QCOMPARE(img.pixel(col + 1, row + 1), expected);
+    }
+
+    // the colours follow the values of each frame
+    const QImage img2 = recorder.render(Values(6, Value(0)));
+    for (int x = 0; x < img2.width(); ++x) {
+        for (int y = 0; y < img2.height(); ++y) {
+            QCOMPARE(img2.pixel(x, y), m_colors[0].rgb());
+        }
+    }
+}
+
+void TestFrameRecorder::tst_graph()
+{
+    // the nodes without coordinates are laid out by the recorder
+    auto attrRange = AttributeRange::parse(0, "a", "int[0,2]");
+    Nodes nodes = createNodes(2, attrRange);
+
+    FrameRecorder recorder(nullptr, attrRange, 1, "");
+    recorder.setColors(m_colors);
+    recorder.setLayout(FrameRecorder::Layout::Graph);
+    recorder.setImageSize(QSize(40, 40));
+    recorder.setNodeRadius(4.);
+    recorder.setGeometry(nodes, Edges());
+
+    const QImage img = recorder.render({ Value(0), Value(2) });
+    QCOMPARE(img.size(), QSize(40, 40));
+    int red = 0, blue = 0;
+    for (int x = 0; x < img.width(); ++x) {
+        for (int y = 0; y < img.height(); ++y) {
+            red += img.pixel(x, y) == m_colors[0].rgb();
+            blue += img.pixel(x, y) == m_colors[2].rgb();
+        }
+    }
+    QVERIFY(red > 0);
+    QVERIFY(blue > 0);
+    QCOMPARE(img.pixel(20, 20), qRgb(255, 255, 255)); // the background
+}
+
+} // evoplex
+
+QTEST_GUILESS_MAIN(evoplex::TestFrameRecorder)
+#include "tst_framerecorder.moc"
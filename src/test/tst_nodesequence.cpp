@@ -0,0 +1,76 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <set>
+#include <nodesequence.h>
+#include <prg.h>
+#include <QtTest>
+
+using namespace evoplex;
+
+class TestNodeSequence: public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_randomPermutation();
+    void tst_randomPermutationSeed();
+};
+
+void TestNodeSequence::tst_randomPermutation()
+{
+    PRG prg(123);
+    for (quint64 n : {1, 2, 3, 5, 16, 17, 100, 1000, 4097}) {
+        RandomPermutation perm(n, &prg);
+        QCOMPARE(perm.size(), n);
+        std::set<quint64> values;
+        for (quint64 i = 0; i < n; ++i) {
+            const quint64 v = perm.at(i);
+            QVERIFY(v < n);
+            values.insert(v);
+        }
+        // it must be a bijection
+        QCOMPARE(static_cast<quint64>(values.size()), n);
+    }
+}
+
+void TestNodeSequence::tst_randomPermutationSeed()
+{
+    const quint64 n = 1000;
+    PRG prg1(0);
+    PRG prg2(0);
+    RandomPermutation p1(n, &prg1);
+    RandomPermutation p2(n, &prg2);
+    RandomPermutation p3(n, &prg1);
+
+    bool samePerm = true;
+    bool identity = true;
+    for (quint64 i = 0; i < n; ++i) {
+        QCOMPARE(p1.at(i), p2.at(i));
+        if (p1.at(i) != p3.at(i)) samePerm = false;
+        if (p1.at(i) != i) identity = false;
+    }
+    QVERIFY(!samePerm);
+    QVERIFY(!identity);
+}
+
+QTEST_MAIN(TestNodeSequence)
+#include "tst_nodesequence.moc"
@@ -0,0 +1,148 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <core/pluginindex.h>
+
+using namespace evoplex;
+
+class TestPluginIndex: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase() {}
+    void tst_insert();
+    void tst_outdated();
+    void tst_prune();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_libA;
+    QString m_libB;
+    QJsonObject m_metaA;
+    QJsonObject m_metaB;
+
+    QString path(const QString& fileName) const { return m_dir.path() + "/" + fileName; }
+    static void writeFile(const QString& filePath, const QByteArray& content);
+};
+
+void TestPluginIndex::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_libA = path("libA.so");
+    m_libB = path("libB.so");
+    writeFile(m_libA, "library A");
+    writeFile(m_libB, "library B");
+    m_metaA = {{"uid", "a"}, {"version", 1}};
+    m_metaB = {{"uid", "b"}, {"version", 2}};
+}
+
+void TestPluginIndex::writeFile(const QString& filePath, const QByteArray& content)
+{
+    QFile file(filePath);
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+    file.write(content);
+}
+
+void TestPluginIndex::tst_insert()
+{
+    const QString indexPath = path("insert/plugins.json");
+    QString error;
+    {
+        PluginIndex index(indexPath);
+        QCOMPARE(index.size(), 0);
+        QVERIFY(index.metaData(m_libA).isEmpty());
+        index.insert(m_libA, m_metaA);
+        index.insert(m_libB, m_metaB);
+        QCOMPARE(index.metaData(m_libA), m_metaA);
+        QVERIFY(index.save(error));
+        QVERIFY(error.isEmpty());
+    }
+    QVERIFY(QFile::exists(indexPath));
+
+    PluginIndex index(indexPath);
+    QCOMPARE(index.size(), 2);
+    QCOMPARE(index.metaData(m_libA), m_metaA);
+    QCOMPARE(index.metaData(m_libB), m_metaB);
+    QVERIFY(index.metaData(path("libC.so")).isEmpty());
+
+    index.remove(m_libB);
+    QCOMPARE(index.size(), 1);
+    QVERIFY(index.metaData(m_libB).isEmpty());
+}
+
+void TestPluginIndex::tst_outdated()
+{
+    const QString indexPath = path("outdated/plugins.json");
+    const QString lib = path("libOutdated.so");
+    writeFile(lib, "version 1");
+    QString error;
+    {
+        PluginIndex index(indexPath);
+        index.insert(lib, m_metaA);
+        QVERIFY(index.save(error));
+    }
+
+    // the library has been rebuilt
+    writeFile(lib, "version 2 is larger");
+    PluginIndex index(indexPath);
+    QVERIFY(index.metaData(lib).isEmpty());
+    QCOMPARE(index.size(), 0);
+
+    // a missing library is not in the index either
+    index.insert(lib, m_metaB);
+    QVERIFY(QFile::remove(lib));
+    QVERIFY(index.metaData(lib).isEmpty());
+
+    // nor a corrupted index
+    writeFile(indexPath, "{ not json");
+    QCOMPARE(PluginIndex(indexPath).size(), 0);
+}
+
+void TestPluginIndex::tst_prune()
+{
+    const QString indexPath = path("prune/plugins.json");
+    QString error;
+    {
+        PluginIndex index(indexPath);
+        index.insert(m_libA, m_metaA);
+        index.insert(m_libB, m_metaB);
+        QVERIFY(index.save(error));
+    }
+    {
+        // only A is listed this time
+        PluginIndex index(indexPath);
+        QCOMPARE(index.metaData(m_libA), m_metaA);
+        QVERIFY(index.save(error));
+    }
+
+    PluginIndex index(indexPath);
+    QCOMPARE(index.size(), 1);
+    QCOMPARE(index.metaData(m_libA), m_metaA);
+    QVERIFY(index.metaData(m_libB).isEmpty());
+}
+
+QTEST_MAIN(TestPluginIndex)
+#include "tst_pluginindex.moc"
@@ -37,6 +37,7 @@ private slots:
     void tst_uniformInt();
     void tst_uniformSizeT();
     void tst_uniformFloat();
+    void tst_draws();
 };
 
 void TestPRG::tst_prg()
@@ -202,5 +203,25 @@ void TestPRG::tst_uniformFloat()
     QVERIFY(v == min);
 }
 
+void TestPRG::tst_draws()
+{
+    auto prg = std::unique_ptr<PRG>(new PRG(0));
+    QCOMPARE(prg->draws(), 0ULL);
+
+    prg->uniform(10);
+    const unsigned long long draws = prg->draws();
+    QVERIFY(draws > 0);
+    prg->bernoulli();
+    QVERIFY(prg->draws() > draws);
+
+    // counting the draws does not change the sequence
+    std::mt19937 mteng(0);
+    auto prg2 = std::unique_ptr<PRG>(new PRG(0));
+    for (int i = 0; i < 100; ++i) {
+        std::uniform_int_distribution<int> d(0, 1000);
+        QCOMPARE(prg2->uniform(d), d(mteng));
+    }
+}
+
 QTEST_MAIN(TestPRG)
 #include "tst_prg.moc"
@@ -0,0 +1,161 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2016 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <gui/seriesbuffer.h>
+
+namespace evoplex {
+class TestSeriesBuffer: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_append();
+    void tst_merge();
+    void tst_ordering();
+    void tst_stride();
+    void tst_clear();
+};
+
+void TestSeriesBuffer::tst_append()
+{
+    SeriesBuffer buffer(4);
+    QVERIFY(buffer.isEmpty());
+    QVERIFY(buffer.points().isEmpty());
+
+    // one point per bucket; the repeated points are drawn once
+    QVector<QPointF> expected;
+    for (int x = 0; x < 4; ++x) {
+        buffer.append(QPointF(x, x));
+        expected.push_back(QPointF(x, x));
+    }
+    QVERIFY(!buffer.isEmpty());
+    QCOMPARE(buffer.bucketWidth(), 1.);
+    QCOMPARE(buffer.points(), expected);
+}
+
+void TestSeriesBuffer::tst_merge()
+{
+    SeriesBuffer buffer(4);
+    auto y = [](int x) { return x % 2 ? 10. : 0.; };
+
+    // the 5th bucket merges the first four into two buckets
+    QVector<QPointF> expected;
+    for (int x = 0; x < 8; ++x) {
+        buffer.append(QPointF(x, y(x)));
+        expected.push_back(QPointF(x, y(x)));
+    }
+    QCOMPARE(buffer.bucketWidth(), 2.);
+    QCOMPARE(buffer.points(), expected); // each bucket still has all its points
+
+    // now, each bucket keeps only its first, min, max and last points
+    for (int x = 8; x < 16; ++x) {
+        buffer.append(QPointF(x, y(x)));
+    }
+    QCOMPARE(buffer.bucketWidth(), 4.);
+    expected.clear();
+    for (int x0 = 0; x0 < 16; x0 += 4) {
+        expected << QPointF(x0, 0.) << QPointF(x0 + 1, 10.) << QPointF(x0 + 3, 10.);
+    }
+    QCOMPARE(buffer.points(), expected);
+
+    // the max comes before the min when it's the first one in x
+    SeriesBuffer buffer2(2);
+    buffer2.append(QPointF(0, 5));
+    buffer2.append(QPointF(1, -3));
+    buffer2.append(QPointF(2, 9));
+    buffer2.append(QPointF(3, 4));
+    QCOMPARE(buffer2.bucketWidth(), 2.);
+    expected.clear();
+    expected << QPointF(0, 5) << QPointF(1, -3) << QPointF(2, 9) << QPointF(3, 4);
+    QCOMPARE(buffer2.points(), expected);
+}
+
+void TestSeriesBuffer::tst_ordering()
+{
+    const int maxBuckets = 8;
+    SeriesBuffer buffer(maxBuckets);
+    qreal minY = 1000.;
+    qreal maxY = -1.;
+    for (int x = 0; x < 1000; ++x) {
+        const qreal y = (x * 37) % 101; // scattered values in [0,100]
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+        buffer.append(QPointF(x, y));
+    }
+
+    const QVector<QPointF> points = buffer.points();
+    QVERIFY(points.size() <= 4 * maxBuckets);
+    QCOMPARE(points.first().x(), 0.);
+    QCOMPARE(points.last().x(), 999.);
+    qreal pointsMinY = points.first().y();
+    qreal pointsMaxY = points.first().y();
+    for (int i = 1; i < points.size(); ++i) {
+        QVERIFY(points.at(i - 1).x() <= points.at(i).x());
+        pointsMinY = qMin(pointsMinY, points.at(i).y());
+        pointsMaxY = qMax(pointsMaxY, points.at(i).y());
+    }
+    // the extremes are never dropped
+    QCOMPARE(pointsMinY, minY);
+    QCOMPARE(pointsMaxY, maxY);
+}
+
+void TestSeriesBuffer::tst_stride()
+{
+    // the points are farther apart than the buckets, e.g., outputInterval > 1
+    const int maxBuckets = 16;
+    for (int stride : {2, 10, 1000}) {
+        SeriesBuffer buffer(maxBuckets);
+        for (int i = 0; i < 20000; ++i) {
+            buffer.append(QPointF(i * stride, i % 7));
+        }
+        const QVector<QPointF> points = buffer.points();
+        QVERIFY(points.size() <= 4 * maxBuckets);
+        QCOMPARE(points.first().x(), 0.);
+        QCOMPARE(points.last().x(), 19999. * stride);
+        for (int i = 1; i < points.size(); ++i) {
+            QVERIFY(points.at(i - 1).x() <= points.at(i).x());
+        }
+    }
+}
+
+void TestSeriesBuffer::tst_clear()
+{
+    SeriesBuffer buffer(2);
+    for (int x = 0; x < 10; ++x) {
+        buffer.append(QPointF(x, x));
+    }
+    QVERIFY(buffer.bucketWidth() > 1.);
+    buffer.clear();
+    QVERIFY(buffer.isEmpty());
+    QCOMPARE(buffer.bucketWidth(), 1.);
+
+    // it starts over from the next point
+    buffer.append(QPointF(100, 1));
+    buffer.append(QPointF(101, 2));
+    QCOMPARE(buffer.points(), QVector<QPointF>({QPointF(100, 1), QPointF(101, 2)}));
+}
+
+} // evoplex
+
+QTEST_GUILESS_MAIN(evoplex::TestSeriesBuffer)
+#include "tst_seriesbuffer.moc"
@@ -0,0 +1,265 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <QThread>
+#include <QtTest>
+#include <core/include/attributerange.h>
+#include <core/include/enum.h>
+#include <core/include/nodes.h>
+#include <core/nodes_p.h>
+#include <core/snapshot.h>
+
+using namespace evoplex;
+
+class TestSnapshot: public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase() {}
+    void tst_publish();
+    void tst_stepInterval();
+    void tst_changes();
+    void tst_concurrency();
+
+private:
+    Nodes m_nodes;
+};
+
+void TestSnapshot::initTestCase()
+{
+    AttributesScope attrsScope;
+    auto attrRange = AttributeRange::parse(0, "a", "int[0,1000]");
+    attrsScope.insert(attrRange->attrName(), attrRange);
+    QString errorMsg;
+    m_nodes = NodesPrivate::fromCmd("*100;min", attrsScope,
+                                    GraphType::Undirected, errorMsg);
+    QCOMPARE(m_nodes.size(), size_t(100));
+}
+
+void TestSnapshot::tst_publish()
+{
+    NodesSnapshot snapshot(0);
+    QCOMPARE(snapshot.attrId(), 0);
+    QVERIFY(!snapshot.acquire());
+    QCOMPARE(snapshot.front().step, -1);
+    QVERIFY(!snapshot.value(0).isValid());
+
+    snapshot.publish(m_nodes, 0);
+    QVERIFY(snapshot.acquire());
+    QVERIFY(!snapshot.acquire()); // nothing new
+    QCOMPARE(snapshot.front().step, 0);
+    QCOMPARE(snapshot.front().values.size(), m_nodes.size());
+    QCOMPARE(snapshot.value(99), Value(0));
+    QVERIFY(!snapshot.value(100).isValid());
+
+    // the front frame does not change until the reader acquires a new one
+    for (auto const& p : m_nodes) {
+        Node(p.second).setAttr(0, Value(p.first));
+    }
+    snapshot.publish(m_nodes, 1);
+    snapshot.publish(m_nodes, 2);
+    QCOMPARE(snapshot.front().step, 0);
+    QCOMPARE(snapshot.value(99), Value(0));
+
+    // the reader takes only the most recent one
+    QVERIFY(snapshot.acquire());
+    QCOMPARE(snapshot.front().step, 2);
+    QCOMPARE(snapshot.value(99), Value(99));
+    QVERIFY(!snapshot.acquire());
+
+    for (auto const& p : m_nodes) {
+        Node(p.second).setAttr(0, Value(0));
+    }
+}
+
+void TestSnapshot::tst_stepInterval()
+{
+    // time-based: it's due whenever the interval has passed
+    NodesSnapshot timed(0);
+    QCOMPARE(timed.stepInterval(), 0);
+    QVERIFY(timed.isDue(3, true));
+    QVERIFY(!timed.isDue(3, false));
+
+    // step-based: only the multiples of the interval, once each
+    NodesSnapshot snapshot(0, 10);
+    QCOMPARE(snapshot.stepInterval(), 10);
+    QVERIFY(snapshot.isDue(0, false));
+    snapshot.publish(m_nodes, 0);
+    QVERIFY(!snapshot.isDue(0, true)); // already published
+    QVERIFY(!snapshot.isDue(5, true));
+    QVERIFY(!snapshot.isDue(19, true));
+    QVERIFY(snapshot.isDue(10, false));
+    QVERIFY(snapshot.isDue(20, false));
+    snapshot.publish(m_nodes, 20);
+    QVERIFY(!snapshot.isDue(20, false));
+    QVERIFY(snapshot.acquire());
+    QCOMPARE(snapshot.front().step, 20);
+}
+
+void TestSnapshot::tst_changes()
+{
+    auto setAttr = [this](int id, int v) { Node(m_nodes.at(id)).setAttr(0, Value(v)); };
+    auto changed = [](const NodesSnapshot& s) {
+        std::vector<int> ids = s.front().changed;
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        return ids;
+    };
+
+    NodesSnapshot snapshot(0);
+    snapshot.publish(m_nodes, 0);
+    QVERIFY(snapshot.acquire());
+    QVERIFY(snapshot.front().allChanged); // nothing to compare with
+
+    setAttr(3, 1);
+    setAttr(7, 1);
+    snapshot.publish(m_nodes, 1);
+    QVERIFY(snapshot.acquire());
+    QVERIFY(!snapshot.front().allChanged);
+    QCOMPARE(changed(snapshot), std::vector<int>({3, 7}));
+
+    snapshot.publish(m_nodes, 2);
+    QVERIFY(snapshot.acquire());
+    QVERIFY(!snapshot.front().allChanged);
+    QVERIFY(snapshot.front().changed.empty());
+
+    // the changes of a skipped frame are carried over
+    setAttr(3, 2);
+    snapshot.publish(m_nodes, 3);
+    setAttr(50, 2);
+    snapshot.publish(m_nodes, 4);
+    QVERIFY(snapshot.acquire());
+    QCOMPARE(snapshot.front().step, 4);
+    QCOMPARE(changed(snapshot), std::vector<int>({3, 50}));
+
+    // too many changes
+    for (int id = 0; id < 30; ++id) {
+        setAttr(id, 3);
+    }
+    snapshot.publish(m_nodes, 5);
+    QVERIFY(snapshot.acquire());
+    QVERIFY(snapshot.front().allChanged);
+
+    for (auto const& p : m_nodes) {
+        Node(p.second).setAttr(0, Value(0));
+    }
+}
+
+void TestSnapshot::tst_concurrency()
+{
+    // all values of a frame are equal to its step, so a torn frame
+    // (i.e., a frame written while it's read) has different values
+    class Writer : public QThread {
+    public:
+        Writer(const Nodes& nodes, NodesSnapshot& snapshot, int lastStep)
+            : m_nodes(nodes), m_snapshot(snapshot), m_lastStep(lastStep) {}
+    protected:
+        void run() override {
+            for (int step = 0; step <= m_lastStep; ++step) {
+                for (auto const& p : m_nodes) {
+                    Node(p.second).setAttr(0, Value(step % 1000));
+                }
+                m_snapshot.publish(m_nodes, step);
+            }
+        }
+    private:
+        const Nodes& m_nodes;
+        NodesSnapshot& m_snapshot;
+        const int m_lastStep;
+    };
+
+    NodesSnapshot snapshot(0);
+    const int lastStep = 2000;
+    Writer writer(m_nodes, snapshot, lastStep);
+    writer.start();
+
+    int prevStep = -1;
+    bool consistent = true;
+    while (prevStep < lastStep) {
+        if (!snapshot.acquire()) {
+            continue;
+        }
+        const NodesSnapshot::Frame& frame = snapshot.front();
+        consistent &= frame.step > prevStep;
+        for (const Value& v : frame.values) {
+            consistent &= v == Value(frame.step % 1000);
+        }
+        prevStep = frame.step;
+    }
+    writer.wait();
+    QVERIFY(consistent);
+}
+
+void TestSnapshot::tst_changesConcurrency()
+{
+    // one node changes per step, so the reader keeps a copy of the
+    // values up to date with the changes only
+    class Writer : public QThread {
+    public:
+        Writer(const Nodes& nodes, NodesSnapshot& snapshot, int lastStep)
+            : m_nodes(nodes), m_snapshot(snapshot), m_lastStep(lastStep) {}
+    protected:
+        void run() override {
+            for (int step = 0; step <= m_lastStep; ++step) {
+                const int id = step % static_cast<int>(m_nodes.size());
+                Node(m_nodes.at(id)).setAttr(0, Value(step % 1000));
+                m_snapshot.publish(m_nodes, step);
+                yieldCurrentThread(); // let the reader take most of the frames
+            }
+        }
+    private:
+        const Nodes& m_nodes;
+        NodesSnapshot& m_snapshot;
+        const int m_lastStep;
+    };
+
+    NodesSnapshot snapshot(0);
+    const int lastStep = 2000;
+    Writer writer(m_nodes, snapshot, lastStep);
+    writer.start();
+
+    std::vector<Value> values;
+    bool consistent = true;
+    while (snapshot.front().step < lastStep) {
+        if (!snapshot.acquire()) {
+            continue;
+        }
+        const NodesSnapshot::Frame& frame = snapshot.front();
+        if (frame.allChanged) {
+            values = frame.values;
+        } else {
+            for (const int id : frame.changed) {
+                values[static_cast<size_t>(id)] = frame.values[static_cast<size_t>(id)];
+            }
+        }
+        consistent &= values == frame.values;
+    }
+    writer.wait();
+    QVERIFY(consistent);
+
+    for (auto const& p : m_nodes) {
+        Node(p.second).setAttr(0, Value(0));
+    }
+}
+
+QTEST_MAIN(TestSnapshot)
+#include "tst_snapshot.moc"
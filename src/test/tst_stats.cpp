@@ -0,0 +1,110 @@
+/**
+ *  This file is part of Evoplex.
+ *
+ *  Evoplex is a multi-agent system for networks.
+ *  Copyright (C) 2018 - Marcos Cardinot <marcos@cardinot.net>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <prg.h>
+#include <stats.h>
+#include <QtTest>
+
+using namespace evoplex;
+
+class TestStats: public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase() {}
+    void cleanupTestCase() {}
+    void tst_runningStatsEmpty();
+    void tst_runningStatsSmall();
+    void tst_runningStatsLarge();
+};
+
+void TestStats::tst_runningStatsEmpty()
+{
+    RunningStats s;
+    QCOMPARE(s.count(), 0);
+    QCOMPARE(s.mean(), 0.);
+    QCOMPARE(s.variance(), 0.);
+    QCOMPARE(s.median(), 0.);
+}
+
+void TestStats::tst_runningStatsSmall()
+{
+    // the median is exact for up to five values
+    RunningStats s;
+    s.add(3.);
+    QCOMPARE(s.count(), 1);
+    QCOMPARE(s.mean(), 3.);
+    QCOMPARE(s.variance(), 0.);
+    QCOMPARE(s.min(), 3.);
+    QCOMPARE(s.max(), 3.);
+    QCOMPARE(s.median(), 3.);
+
+    s.add(-1.);
+    QCOMPARE(s.mean(), 1.);
+    QCOMPARE(s.variance(), 8.);
+    QCOMPARE(s.min(), -1.);
+    QCOMPARE(s.median(), 1.);
+
+    s.add(10.);
+    s.add(2.);
+    s.add(4.);
+    QCOMPARE(s.count(), 5);
+    QCOMPARE(s.mean(), 3.6);
+    QCOMPARE(s.variance(), 16.3);
+    QCOMPARE(s.min(), -1.);
+    QCOMPARE(s.max(), 10.);
+    QCOMPARE(s.median(), 3.);
+}
+
+void TestStats::tst_runningStatsLarge()
+{
+    PRG prg(123);
+    std::vector<double> values;
+    RunningStats s;
+    for (int i = 0; i < 10000; ++i) {
+        const double v = prg.uniform(100.0);
+        values.emplace_back(v);
+        s.add(v);
+    }
+
+    double mean = 0.;
+    for (double v : values) mean += v;
+    mean /= values.size();
+    double var = 0.;
+    for (double v : values) var += (v - mean) * (v - mean);
+    var /= (values.size() - 1);
+
+    QCOMPARE(s.count(), static_cast<int>(values.size()));
+    QVERIFY(std::abs(s.mean() - mean) < 1e-9);
+    QVERIFY(std::abs(s.variance() - var) < 1e-6);
+    QCOMPARE(s.min(), *std::min_element(values.begin(), values.end()));
+    QCOMPARE(s.max(), *std::max_element(values.begin(), values.end()));
+
+    // approximation of the median: within 1% of the range
+    std::sort(values.begin(), values.end());
+    const double median = (values[4999] + values[5000]) / 2.;
+    QVERIFY(std::abs(s.median() - median) < 1.);
+}
+
+QTEST_MAIN(TestStats)
+#include "tst_stats.moc"